@@ -1,9 +1,16 @@
 #include "application.hpp"
 #include "SDL_render.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <managers/asset_loader/asset_loader.hpp>
+#include <managers/hot_reloader/hot_reloader.hpp>
 #include <managers/input_manager/input_manager.hpp>
 #include <managers/resource_manager/resource_manager.hpp>
+#include <text/text_renderer.hpp>
+#include <utils/random.hpp>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -11,18 +18,33 @@
 
 namespace wbz {
 
-void Application::run() {
+void Application::run(int argc, char *argv[]) {
   auto &app = instance();
+  app._config.parse_args(argc, argv);
   app.init();
 
 #ifdef __EMSCRIPTEN__
-  emscripten_set_main_loop(Application::single_iter, 0, 1);
+  // 0 follows requestAnimationFrame, which is the browser's vsync.
+  emscripten_set_main_loop(Application::single_iter,
+                           app._config.pacing() == PacingMode::VSYNC
+                               ? 0
+                               : app._config.desired_fps(),
+                           1);
 #endif
 
-  while (app.is_playing()) {
-    app.handle_events();
-    app.update();
-    app.render();
+  if (app._config.threaded_simulation()) {
+    app._simulation_thread = std::thread([&app] { app.simulation_loop(); });
+
+    while (app.is_playing()) {
+      app.handle_events();
+      app._pacer.end_frame(app.render());
+    }
+
+    app._simulation_thread.join();
+  } else {
+    while (app.is_playing()) {
+      single_iter();
+    }
   }
 
   app.cleanup();
@@ -37,7 +59,8 @@ void Application::single_iter(void) {
   auto &app = instance();
   app.handle_events();
   app.update();
-  app.render();
+  app.publish_snapshot();
+  app._pacer.end_frame(app.render());
 
   if (!app.is_playing()) {
     app.cleanup();
@@ -46,11 +69,94 @@ void Application::single_iter(void) {
 
 void Application::init() {
   std::cout << "Initializing the application instance\n";
-  _window = Window::from_config(_config.window_config());
+  _init_time = SDL_GetPerformanceCounter();
+  const auto &capture = _config.capture();
+  _window = capture.enabled ? Window::offscreen(_config.window_config())
+                            : Window::from_config(_config.window_config());
+
+  if (_config.deterministic()) {
+    uint64_t seed = _config.seed();
+    uint16_t simulation_hz = _config.simulation_hz();
+    if (!_config.replay_path().empty()) {
+      _input_replay.open(_config.replay_path());
+      seed = _input_replay.header().seed;
+      simulation_hz = _input_replay.header().simulation_hz;
+    } else if (!_config.record_path().empty()) {
+      _input_recorder.start(_config.record_path(), simulation_hz, seed);
+    }
 
-  _last_time = SDL_GetPerformanceCounter();
+    _fixed_delta_time = 1.0 / simulation_hz;
+    utils::Random::set_base_seed(seed);
+    std::cout << "Deterministic simulation, seed " << seed << "\n";
+  }
+  if (!_config.checksum_path().empty()) {
+    _checksums = std::fopen(_config.checksum_path().c_str(), "w");
+    if (!_checksums) {
+      throw std::runtime_error("Failed to open " + _config.checksum_path());
+    }
+  }
+
+  TextRenderer::instance().init();
+  managers::ResourceManager::set_texture_budget(
+      _config.texture_budget_bytes());
+
+  auto &loader = managers::AssetLoader::instance();
+  loader.start();
+  loader.load_font(TextRenderer::font_file(), TextRenderer::font_sizes());
+  for (const char *texture : {"map.png", "janemba.png", "goku_ssjb.png"}) {
+    loader.load_texture(texture);
+  }
 
+  _game_manager.set_ai_vs_ai(_config.ai_vs_ai());
   _game_manager.init();
+  if (!_config.q_table_path().empty()) {
+    _game_manager.load_q_table(_config.q_table_path());
+  }
+  if (_config.planning()) {
+    if (_config.deterministic()) {
+      std::cout << "Planning is disabled in deterministic runs\n";
+    } else {
+      _planning = true;
+      _game_manager.enable_planning();
+    }
+  }
+  if (!_config.trajectory_path().empty()) {
+    _trajectory.open(_config.trajectory_path(), utils::Random::base_seed());
+    _game_manager.set_trajectory_writer(&_trajectory);
+  }
+
+#ifdef __EMSCRIPTEN__
+  // The browser paces the main loop; only measure.
+  _pacer.configure(PacingMode::OFF, _config.desired_fps());
+#else
+  _pacer.configure(_config.pacing(), _config.desired_fps());
+#endif
+  const double tick_hz = _fixed_delta_time > 0.0 ? 1.0 / _fixed_delta_time
+                                                 : _config.simulation_hz();
+  _game_manager.set_input_buffer_ticks(
+      static_cast<uint64_t>(INPUT_BUFFER_SECONDS * tick_hz));
+  // AI decisions run at their own rate, in whole ticks.
+  const double decision_hz = std::max<uint16_t>(1, _config.ai_decision_hz());
+  _game_manager.set_decision_schedule(
+      static_cast<uint32_t>(std::lround(tick_hz / decision_hz)),
+      _config.ai_decision_budget());
+  managers::HotReloader::instance().start();
+
+  if (capture.enabled) {
+    // Captured frames must not depend on how fast assets stream in.
+    while (!loader.is_idle()) {
+      loader.pump(_window.renderer().get(), _config.asset_upload_budget_ms());
+      SDL_Delay(1);
+    }
+    _capture.open(capture);
+  }
+
+  _last_time = SDL_GetPerformanceCounter();
+  _replay_start_time = _last_time;
+
+  if (_config.start_headless()) {
+    toggle_headless();
+  }
 
   std::cout << "Successfully initialized the application instance\n";
 }
@@ -74,109 +180,327 @@ void Application::handle_events() {
       case SDLK_h:
         toggle_headless();
         break;
+
+      case SDLK_F5:
+        _show_frame_stats = !_show_frame_stats;
+        if (!_show_frame_stats) {
+          _renderer.set_overlay("");
+        }
+        break;
+
+      case SDLK_F1:
+      case SDLK_F2:
+      case SDLK_F3:
+      case SDLK_F4: {
+        auto category =
+            static_cast<DebugCategory>(e.key.keysym.sym - SDLK_F1);
+        bool enabled = DebugDraw::toggle(category);
+        std::cout << "Debug " << DebugDraw::name(category) << ": "
+                  << (enabled ? "ON" : "OFF") << std::endl;
+        break;
+      }
       }
       break;
     }
 
-    wbz::managers::InputManager::handle_events(e);
+    if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) {
+      std::lock_guard<std::mutex> lock(_input_mutex);
+      _input_events.push_back(e);
+    }
   }
 }
 
+void Application::simulation_loop() {
+  using clock = std::chrono::steady_clock;
+  const auto tick = std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(1.0 / _config.simulation_hz()));
+  auto next_tick = clock::now();
+
+  while (is_playing()) {
+    update();
+    publish_snapshot();
+
+    // Headless runs go as fast as possible.
+    next_tick += tick;
+    if (_headless) {
+      next_tick = clock::now();
+    } else {
+      if (_planning) {
+        _planning_updates += _game_manager.plan(next_tick - PLANNING_MARGIN);
+      }
+      std::this_thread::sleep_until(next_tick);
+    }
+  }
+}
+
+void Application::dispatch_input() {
+  {
+    std::lock_guard<std::mutex> lock(_input_mutex);
+    _input_dispatch.swap(_input_events);
+  }
+
+  // A replay ignores the live keyboard.
+  if (!_input_replay.is_open()) {
+    for (const auto &event : _input_dispatch) {
+      _input_recorder.record(_tick, event);
+      managers::InputManager::handle_events(event, event_tick(event));
+    }
+  }
+  _input_dispatch.clear();
+}
+
+// The tick an event happened on, from its SDL timestamp. Events queued while
+// the simulation was busy are handled late but keep the tick they belong to,
+// so input buffer windows and latency stats measure from the key press.
+uint64_t Application::event_tick(const SDL_Event &event) const {
+  if (_config.deterministic()) {
+    return _tick;
+  }
+
+  uint32_t now = SDL_GetTicks();
+  uint32_t age_ms = now > event.key.timestamp ? now - event.key.timestamp : 0;
+  uint64_t ticks_ago =
+      static_cast<uint64_t>(age_ms) * _config.simulation_hz() / 1000;
+  return _tick - std::min(_tick, ticks_ago);
+}
+
 void Application::update() {
+  managers::HotReloader::instance().apply_animations(_game_state);
+
   size_t nIter = _headless ? 100000 : 1;
-  for (size_t i = 0; i < nIter; ++i) {
+  for (size_t i = 0; i < nIter && is_playing(); ++i) {
     _current_time = SDL_GetPerformanceCounter();
-    _delta_time = (_current_time - _last_time) /
-                  static_cast<double>(SDL_GetPerformanceFrequency());
+    _delta_time = _config.deterministic()
+                      ? _fixed_delta_time
+                      : (_current_time - _last_time) /
+                            static_cast<double>(SDL_GetPerformanceFrequency());
     _last_time = _current_time;
 
     if (_is_paused) {
       return;
     }
 
-    update_camera(_delta_time);
+    step();
+  }
+}
 
-    for (auto &entity : _game_state.entities) {
-      entity->update(_delta_time);
-    }
-    _game_state.map.update(_delta_time);
+// One simulation tick. Input is applied per tick so recordings and replays
+// line up with the tick counter whatever the frame rate.
+void Application::step() {
+  dispatch_input();
+  if (_input_replay.is_open() && !_input_replay.feed(_tick)) {
+    finish_replay();
+    return;
+  }
+  managers::InputManager::update(_tick);
+
+  for (auto &entity : _game_state.entities) {
+    entity->update(_delta_time);
+  }
+  _game_state.map.update(_delta_time);
+
+  _game_manager.update(_delta_time);
+  ++_tick;
 
-    _game_manager.update(_delta_time);
-    managers::InputManager::update();
+  if (_checksums) {
+    std::fprintf(_checksums, "%llu %016llx\n",
+                 static_cast<unsigned long long>(_tick),
+                 static_cast<unsigned long long>(
+                     _game_state.checksum(_tick)));
   }
 }
 
-void Application::update_camera(double delta_time) {
-  if (!_game_state.player_character) {
+void Application::finish_replay() {
+  double seconds = (SDL_GetPerformanceCounter() - _replay_start_time) /
+                   static_cast<double>(SDL_GetPerformanceFrequency());
+  std::cout << "Replay finished: " << _tick << " ticks in " << seconds
+            << "s (" << _tick / std::max(seconds, 1e-9)
+            << " ticks/s), final checksum " << std::hex
+            << _game_state.checksum(_tick) << std::dec << "\n";
+  _is_playing = false;
+}
+
+void Application::publish_snapshot() {
+  if (_headless || !_frame_requested.exchange(false)) {
     return;
   }
 
-  Vector2f playerPos = _game_state.player_character->mover().position();
-  Vector2f aiPos;
-  for (auto &ent : _game_state.entities) {
-    auto c = std::dynamic_pointer_cast<entities::Character>(ent);
-    if (c && c != _game_state.player_character) {
-      aiPos = c->mover().position();
-      break;
+  // Presentation state only advances for frames that are actually drawn;
+  // the clamp keeps the first frame after a headless stretch from jumping.
+  // Captures present one fixed tick per frame.
+  uint64_t now = SDL_GetPerformanceCounter();
+  double present_delta =
+      _config.capture().enabled ? _fixed_delta_time
+      : _last_present_time == 0
+          ? 0.0
+          : std::min(0.1, (now - _last_present_time) /
+                              static_cast<double>(
+                                  SDL_GetPerformanceFrequency()));
+  _last_present_time = now;
+
+  if (!_is_paused) {
+    for (auto &entity : _game_state.entities) {
+      entity->update_presentation(present_delta);
     }
   }
 
-  Vector2f midpoint =
-      Vector2f((playerPos.x + aiPos.x) * 0.5f, (playerPos.y + aiPos.y) * 0.5f);
+  RenderSnapshot &snapshot = _snapshots.back();
+  snapshot.clear();
+  snapshot.tick = _tick;
 
-  float dist = playerPos.sub(aiPos).mag();
-
-  float desired = 1.0f - (dist - 300.0f) / 300.0f;
-  // clamp
-  if (desired < _min_scale)
-    desired = _min_scale;
-  if (desired > _max_scale)
-    desired = _max_scale;
-
-  _camera_target_scale = desired;
+  _game_state.map.snapshot(snapshot);
+  for (auto &entity : _game_state.entities) {
+    entity->snapshot(snapshot);
+  }
 
-  float alpha = 3.0f * static_cast<float>(delta_time);
-  _camera_scale += (_camera_target_scale - _camera_scale) * alpha;
+  const auto &round = _game_state.combat_state;
+  snapshot.hud = {round.round_timer, round.round_number,
+                  round.player_rounds_won, round.opponent_rounds_won};
 
-  float screenW = (float)_config.window_config().width;
-  float screenH = (float)_config.window_config().height;
+  if (_game_state.player_character) {
+    snapshot.has_focus = true;
+    snapshot.focus_a = _game_state.player_character->mover().position();
+    for (auto &entity : _game_state.entities) {
+      auto character = std::dynamic_pointer_cast<entities::Character>(entity);
+      if (character && character != _game_state.player_character) {
+        snapshot.focus_b = character->mover().position();
+        break;
+      }
+    }
+  }
 
-  _camera_x_offset = (screenW * 0.5f) / _camera_scale - midpoint.x;
-  _camera_y_offset = (screenH * 0.5f) / _camera_scale - midpoint.y;
+  _snapshots.publish();
 }
 
-void Application::render() {
+bool Application::render() {
   if (_headless)
-    return;
+    return false;
 
   auto renderer = _window.renderer().get();
 
-  // SDL_RenderSetScale(renderer, _camera_scale, _camera_scale);
+  auto &loader = managers::AssetLoader::instance();
+  if (!loader.is_idle()) {
+    loader.pump(renderer, _config.asset_upload_budget_ms());
+  }
+  managers::HotReloader::instance().apply_textures(renderer);
 
-  // SDL_Rect viewport;
-  // viewport.x = static_cast<int>(_camera_x_offset * _camera_scale);
-  // viewport.y = static_cast<int>(_camera_y_offset * _camera_scale);
-  // viewport.w = _config.window_config().width;
-  // viewport.h = _config.window_config().height;
-  // SDL_RenderSetViewport(renderer, &viewport);
+  if (!_snapshots.acquire()) {
+    return false;
+  }
+  _frame_requested = true;
+
+  uint64_t now = SDL_GetPerformanceCounter();
+  double frame_delta =
+      _config.capture().enabled ? _fixed_delta_time
+      : _last_frame_time == 0
+          ? 0.0
+          : std::min(0.1, (now - _last_frame_time) /
+                              static_cast<double>(
+                                  SDL_GetPerformanceFrequency()));
+  _last_frame_time = now;
+
+  if (_show_frame_stats) {
+    const FrameStats stats = _pacer.stats();
+    char overlay[96];
+    std::snprintf(overlay, sizeof(overlay),
+                  "p50 %.1f  p95 %.1f  p99 %.1f ms  jank %llu",
+                  stats.p50_ms, stats.p95_ms, stats.p99_ms,
+                  static_cast<unsigned long long>(stats.janks));
+    _renderer.set_overlay(overlay);
+  }
 
-  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-  SDL_RenderClear(renderer);
+  _renderer.draw(renderer, _snapshots.front(), frame_delta,
+                 _config.window_config().width,
+                 _config.window_config().height);
 
-  _game_state.map.render(renderer);
-  for (auto &entity : _game_state.entities) {
-    entity->render(renderer);
+  if (_config.capture().enabled &&
+      !_capture.capture(_window.surface().get(), _renderer.last_timings())) {
+    _is_playing = false;
   }
 
-  SDL_RenderPresent(renderer);
+  if (!_first_frame_presented) {
+    _first_frame_presented = true;
+    std::cout << "First frame presented "
+              << (SDL_GetPerformanceCounter() - _init_time) * 1000.0 /
+                     SDL_GetPerformanceFrequency()
+              << "ms after init (assets loaded: " << loader.completed() << "/"
+              << loader.requested() << ")\n";
+  }
 
-  SDL_RenderSetScale(renderer, 1.0f, 1.0f);
-  SDL_RenderSetViewport(renderer, nullptr);
+  return true;
 }
 
 void Application::cleanup() {
+  if (_cleaned_up) {
+    return;
+  }
+  _cleaned_up = true;
   std::cout << "Cleaning up the application instance\n";
 
+  _is_playing = false;
+  if (_simulation_thread.joinable()) {
+    _simulation_thread.join();
+  }
+
+  if (_checksums) {
+    std::fclose(_checksums);
+    _checksums = nullptr;
+  }
+  _input_recorder.stop(_tick);
+  _trajectory.close();
+  if (_planning) {
+    std::cout << "Planning: " << _planning_updates << " updates over "
+              << _tick << " ticks\n";
+  }
+
+  managers::HotReloader::instance().stop();
+  managers::AssetLoader::instance().shutdown();
+  TextRenderer::instance().cleanup();
+
+  if (_config.capture().enabled) {
+    _capture.close();
+
+    const auto &timings = _renderer.total_timings();
+    const double frames = std::max<uint64_t>(1, _renderer.frames());
+    std::cout << "Captured " << _capture.frames()
+              << " frames; average ms per frame: map " << timings.map / frames
+              << ", sprites " << timings.sprites / frames << ", bars "
+              << timings.bars / frames << ", debug " << timings.debug / frames
+              << ", text " << timings.text / frames << ", present "
+              << timings.present / frames << ", total "
+              << timings.total() / frames << "; last frame drew "
+              << _renderer.last_drawn() << " and culled "
+              << _renderer.last_culled() << " draw calls\n";
+  }
+
+  const FrameStats frames = _pacer.stats();
+  if (frames.frames) {
+    std::cout << "Frame times over the last " << frames.frames
+              << " frames: average " << frames.average_ms << " ms, p50 "
+              << frames.p50_ms << ", p95 " << frames.p95_ms << ", p99 "
+              << frames.p99_ms << ", " << _pacer.histogram().total_janks()
+              << " janks in " << _pacer.histogram().total_frames()
+              << " frames\n";
+  }
+  if (!_config.frame_stats_path().empty()) {
+    _pacer.dump(_config.frame_stats_path());
+  }
+
+  const auto &latency = managers::InputManager::buffer().latency();
+  if (latency.actions) {
+    std::cout << "Input latency over " << latency.actions
+              << " actions: average " << latency.average_ticks()
+              << " ticks / " << latency.average_ms() << " ms, max "
+              << latency.max_ticks << " ticks / " << latency.max_ms
+              << " ms\n";
+  }
+
+  const auto &stats = managers::ResourceManager::texture_stats();
+  std::cout << "Texture cache: " << stats.hits << " hits, " << stats.misses
+            << " misses, " << stats.evictions << " evictions, peak "
+            << stats.peak_bytes << "/" << stats.budget_bytes << " bytes\n";
+  managers::ResourceManager::clear();
+
   _window.cleanup();
   _game_manager.cleanup();
 
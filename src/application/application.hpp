@@ -1,9 +1,23 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <config/config.hpp>
+#include <entities/agent/trajectory_log.hpp>
 #include <iostream>
 #include <managers/game_manager/game_manager.hpp>
+#include <managers/input_manager/input_log.hpp>
+#include <mutex>
+#include <render/frame_capture.hpp>
+#include <render/frame_pacer.hpp>
+#include <render/render_snapshot.hpp>
+#include <render/renderer.hpp>
 #include <state/game_state.hpp>
+#include <thread>
+#include <utils/log.hpp>
+#include <utils/triple_buffer.hpp>
+#include <vector>
 #include <window/window.hpp>
 
 namespace wbz {
@@ -11,7 +25,7 @@ class Application {
 public:
   Application() : _game_manager(_game_state) {}
 
-  static void run();
+  static void run(int argc, char *argv[]);
   static void shutdown();
   static void single_iter(void);
   static Application &instance() {
@@ -25,6 +39,7 @@ public:
   static void toggle_headless() {
     auto &app = instance();
     app._headless = !app._headless;
+    utils::Log::verbose() = !app._headless;
     std::cout << "Headless mode: " << (app._headless ? "ON" : "OFF")
               << std::endl;
   }
@@ -35,27 +50,64 @@ private:
   GameState _game_state;
   managers::GameManager _game_manager;
 
-  bool _is_playing = true;
-  bool _is_paused = false;
+  // Written by the main thread, read by the simulation thread.
+  std::atomic<bool> _is_playing{true};
+  // single_iter() cleans up when play stops, and run() again after it.
+  bool _cleaned_up = false;
+  std::atomic<bool> _is_paused{false};
 
-  bool _headless = false;
+  std::atomic<bool> _headless{false};
+
+  // The simulation publishes snapshots, the main thread draws the latest one.
+  // A snapshot is only built once the renderer has taken the previous one,
+  // so presentation work scales with the frame rate, not the tick rate.
+  std::thread _simulation_thread;
+  utils::TripleBuffer<RenderSnapshot> _snapshots;
+  std::atomic<bool> _frame_requested{true};
+  Renderer _renderer;
+  FramePacer _pacer;
+  bool _show_frame_stats = false;
+  FrameCapture _capture;
+
+  // SDL events must be polled on the main thread; keyboard events are queued
+  // here and fed to the InputManager at the start of the next tick.
+  std::mutex _input_mutex;
+  std::vector<SDL_Event> _input_events;
+  std::vector<SDL_Event> _input_dispatch;
+
+  uint64_t _init_time = 0;
+  bool _first_frame_presented = false;
+  uint64_t _last_present_time = 0;
+  uint64_t _last_frame_time = 0;
+  uint64_t _tick = 0;
+  // How long a press stays in the input buffer.
+  static constexpr double INPUT_BUFFER_SECONDS = 0.1;
+  double _fixed_delta_time = 0.0;
+  std::FILE *_checksums = nullptr;
+
+  managers::InputRecorder _input_recorder;
+  managers::InputReplay _input_replay;
+  uint64_t _replay_start_time = 0;
+  ai::TrajectoryWriter _trajectory;
+  // Planning stops this long before the next tick is due.
+  static constexpr std::chrono::microseconds PLANNING_MARGIN{500};
+  bool _planning = false;
+  uint64_t _planning_updates = 0;
 
   uint64_t _current_time = 0;
   uint64_t _last_time = 0;
   double _delta_time = 0.0;
-  float _camera_scale = 1.0f;
-  float _camera_target_scale = 1.0f;
-  float _min_scale = 0.5f;
-  float _max_scale = 1.2f;
-
-  float _camera_x_offset = 0.0f;
-  float _camera_y_offset = 0.0f;
 
   void init();
   void handle_events();
+  void simulation_loop();
+  void dispatch_input();
+  uint64_t event_tick(const SDL_Event &event) const;
   void update();
-  void update_camera(double delta_time);
-  void render();
+  void step();
+  void finish_replay();
+  void publish_snapshot();
+  bool render();
   void cleanup();
 
   void toggle_pause();
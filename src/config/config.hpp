@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <stdexcept>
+#include <string>
 
 namespace wbz {
 
@@ -9,17 +12,209 @@ struct WindowConfig {
   uint16_t height = 600;
   const char *title = "Wasm Ball Z";
   uint32_t flags = 0;
+  bool vsync = true;
+};
+
+enum class PacingMode {
+  // Uncapped.
+  OFF,
+  // Present blocks on the display, sleeping instead if that does not work.
+  VSYNC,
+  // Sleep, then spin for the last fraction of a millisecond.
+  HYBRID,
+};
+
+enum class CaptureFormat {
+  PPM,
+  RGBA,
+};
+
+// Offscreen capture: renders through the software renderer with the dummy
+// video driver, so it needs no display or GPU.
+struct CaptureConfig {
+  bool enabled = false;
+  // Raw frame stream; a regular file or a FIFO for live viewing.
+  std::string output;
+  CaptureFormat format = CaptureFormat::PPM;
+  // One hash per frame, for golden image comparisons.
+  std::string hashes;
+  // Per-frame render time by subsystem, as CSV.
+  std::string timings;
+  // Stop after this many frames, 0 runs until quit.
+  uint32_t frame_count = 0;
 };
 
 class Config {
 public:
-  Config() : _window_config({}), _desired_fps(60) {}
+  Config()
+      : _window_config({}), _desired_fps(60), _asset_upload_budget_ms(4.0f),
+        _texture_budget_bytes(128u * 1024u * 1024u), _simulation_hz(120),
+        _threaded_simulation(default_threaded_simulation()) {}
 
   uint16_t desired_fps() const { return _desired_fps; }
   const WindowConfig &window_config() const { return _window_config; }
+  float asset_upload_budget_ms() const { return _asset_upload_budget_ms; }
+  size_t texture_budget_bytes() const { return _texture_budget_bytes; }
+  uint16_t simulation_hz() const { return _simulation_hz; }
+  bool threaded_simulation() const { return _threaded_simulation; }
+  const CaptureConfig &capture() const { return _capture; }
+  PacingMode pacing() const { return _pacing; }
+  // Frame time histogram written on exit.
+  const std::string &frame_stats_path() const { return _frame_stats_path; }
+
+  // Deterministic runs step the simulation with a fixed 1 / simulation_hz
+  // and seed every random stream from seed(), so the same inputs give
+  // bit-identical states on native and wasm builds.
+  bool deterministic() const { return _deterministic; }
+  uint64_t seed() const { return _seed; }
+  // Per-tick state checksums, one "tick checksum" line each.
+  const std::string &checksum_path() const { return _checksum_path; }
+
+  // Input logs; recording implies a deterministic run, replaying takes the
+  // seed and tick rate from the log.
+  const std::string &record_path() const { return _record_path; }
+  const std::string &replay_path() const { return _replay_path; }
+  bool start_headless() const { return _start_headless; }
+  // The AI character's transitions, for offline training.
+  const std::string &trajectory_path() const { return _trajectory_path; }
+  // Q-table checkpoint the AI character plays instead of learning from
+  // scratch.
+  const std::string &q_table_path() const { return _q_table_path; }
+  // Dyna planning in the simulation thread's idle time between ticks.
+  // Ignored by deterministic runs, since it depends on wall time.
+  bool planning() const { return _planning; }
+  // How often AI characters pick an action, and how many of them may
+  // decide in one tick (0 for no limit).
+  uint16_t ai_decision_hz() const { return _ai_decision_hz; }
+  uint32_t ai_decision_budget() const { return _ai_decision_budget; }
+  // A second AI character plays the player's side.
+  bool ai_vs_ai() const { return _ai_vs_ai; }
+
+  void parse_args(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::runtime_error("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+
+      if (arg == "--capture") {
+        _capture.enabled = true;
+      } else if (arg == "--capture-output") {
+        _capture.enabled = true;
+        _capture.output = value();
+      } else if (arg == "--capture-format") {
+        std::string format = value();
+        if (format == "ppm") {
+          _capture.format = CaptureFormat::PPM;
+        } else if (format == "rgba") {
+          _capture.format = CaptureFormat::RGBA;
+        } else {
+          throw std::runtime_error("Unknown capture format: " + format);
+        }
+      } else if (arg == "--capture-hashes") {
+        _capture.enabled = true;
+        _capture.hashes = value();
+      } else if (arg == "--capture-timings") {
+        _capture.enabled = true;
+        _capture.timings = value();
+      } else if (arg == "--deterministic") {
+        _deterministic = true;
+      } else if (arg == "--seed") {
+        _deterministic = true;
+        _seed = std::stoull(value());
+      } else if (arg == "--checksums") {
+        _deterministic = true;
+        _checksum_path = value();
+      } else if (arg == "--record") {
+        _deterministic = true;
+        _record_path = value();
+      } else if (arg == "--replay") {
+        _deterministic = true;
+        _replay_path = value();
+      } else if (arg == "--trajectory") {
+        _trajectory_path = value();
+      } else if (arg == "--q-table") {
+        _q_table_path = value();
+      } else if (arg == "--planning") {
+        _planning = true;
+      } else if (arg == "--ai-hz") {
+        _ai_decision_hz = static_cast<uint16_t>(std::stoul(value()));
+      } else if (arg == "--ai-budget") {
+        _ai_decision_budget = static_cast<uint32_t>(std::stoul(value()));
+      } else if (arg == "--ai-vs-ai") {
+        _ai_vs_ai = true;
+      } else if (arg == "--headless") {
+        _start_headless = true;
+      } else if (arg == "--fps") {
+        _desired_fps = static_cast<uint16_t>(std::stoul(value()));
+      } else if (arg == "--pacing") {
+        std::string pacing = value();
+        if (pacing == "off") {
+          _pacing = PacingMode::OFF;
+        } else if (pacing == "vsync") {
+          _pacing = PacingMode::VSYNC;
+        } else if (pacing == "hybrid") {
+          _pacing = PacingMode::HYBRID;
+        } else {
+          throw std::runtime_error("Unknown pacing mode: " + pacing);
+        }
+      } else if (arg == "--frame-stats") {
+        _frame_stats_path = value();
+      } else if (arg == "--capture-frames") {
+        _capture.enabled = true;
+        _capture.frame_count = static_cast<uint32_t>(std::stoul(value()));
+      } else {
+        throw std::runtime_error("Unknown argument: " + arg);
+      }
+    }
+
+    // Frames are captured in lockstep with the fixed ticks that produced
+    // them, so a capture is the same on every run.
+    if (_capture.enabled) {
+      _deterministic = true;
+      _threaded_simulation = false;
+      _pacing = PacingMode::OFF;
+    }
+    // --fps 0 asks for an uncapped frame rate, vsync included.
+    if (_desired_fps == 0) {
+      _pacing = PacingMode::OFF;
+    }
+    _window_config.vsync = _pacing == PacingMode::VSYNC;
+  }
 
 private:
+  // The browser build runs the simulation inside the main loop callback.
+  static constexpr bool default_threaded_simulation() {
+#ifdef __EMSCRIPTEN__
+    return false;
+#else
+    return true;
+#endif
+  }
+
   WindowConfig _window_config;
   uint16_t _desired_fps;
+  float _asset_upload_budget_ms;
+  size_t _texture_budget_bytes;
+  uint16_t _simulation_hz;
+  bool _threaded_simulation;
+  CaptureConfig _capture;
+  PacingMode _pacing = PacingMode::VSYNC;
+  std::string _frame_stats_path;
+  bool _deterministic = false;
+  uint64_t _seed = 0;
+  std::string _checksum_path;
+  std::string _record_path;
+  std::string _replay_path;
+  bool _start_headless = false;
+  std::string _trajectory_path;
+  std::string _q_table_path;
+  bool _planning = false;
+  uint16_t _ai_decision_hz = 30;
+  uint32_t _ai_decision_budget = 0;
+  bool _ai_vs_ai = false;
 };
 } // namespace wbz
@@ -1,11 +1,31 @@
 #include "QLearningAgent.hpp"
+#include "dyna_planner.hpp"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
 
 namespace wbz {
 namespace ai {
-QLearningAgent::QLearningAgent(float learning_rate, float discount_factor,
-                               float exploration_rate)
-    : learning_rate(learning_rate), discount_factor(discount_factor),
-      exploration_rate(exploration_rate), rng(std::random_device{}()) {
+namespace {
+struct QTableHeader {
+  static constexpr uint32_t MAGIC = 0x515a4257; // "WBZQ"
+  static constexpr uint16_t VERSION = 1;
+
+  uint32_t magic = MAGIC;
+  uint16_t version = VERSION;
+  uint16_t action_count = static_cast<uint16_t>(Action::ACTION_COUNT);
+  uint32_t state_count = State::COUNT;
+  uint32_t reserved = 0;
+};
+static_assert(sizeof(QTableHeader) == 16, "QTableHeader is padded");
+} // namespace
+
+QLearningAgent::QLearningAgent(const AgentParams &params)
+    : _params(params), learning_rate(params.learning_rate),
+      discount_factor(params.discount_factor),
+      exploration_rate(params.exploration_rate),
+      _random(utils::Random::stream()) {
 
   for (int i = 0; i < 5; i++) {
     for (int j = 0; j < 5; j++) {
@@ -25,6 +45,7 @@ QLearningAgent::QLearningAgent(float learning_rate, float discount_factor,
     }
   }
 }
+QLearningAgent::~QLearningAgent() = default;
 State QLearningAgent::get_state(const Vector2f &agent_pos,
                                 const Vector2f &opponent_pos,
                                 bool is_opponent_attacking,
@@ -43,31 +64,33 @@ State QLearningAgent::get_state(const Vector2f &agent_pos,
 }
 
 Action QLearningAgent::select_action(const State &state) {
-  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  if (_greedy) {
+    return get_best_action(state);
+  }
 
   if (!state.opponent_in_radar) {
 
-    if (dist(rng) < 0.7f) {
+    if (_random.uniform() < 0.7f) {
 
       std::vector<Action> search_actions = {Action::MOVE_LEFT,
                                             Action::MOVE_RIGHT, Action::MOVE_UP,
                                             Action::MOVE_DOWN};
-      return search_actions[std::uniform_int_distribution<int>(0, 3)(rng)];
+      return search_actions[_random.range(0, 3)];
     }
   }
 
   if (state.distance_bin <= 2) {
-    if (dist(rng) < 0.4f) {
+    if (_random.uniform() < 0.4f) {
       std::vector<Action> attack_actions = {
           Action::LIGHT_PUNCH, Action::HEAVY_PUNCH, Action::LIGHT_KICK,
           Action::HEAVY_KICK};
-      return attack_actions[std::uniform_int_distribution<int>(0, 3)(rng)];
+      return attack_actions[_random.range(0, 3)];
     }
   }
 
-  if (dist(rng) < exploration_rate) {
-    return static_cast<Action>(std::uniform_int_distribution<int>(
-        0, static_cast<int>(Action::ACTION_COUNT) - 1)(rng));
+  if (_random.uniform() < exploration_rate) {
+    return static_cast<Action>(
+        _random.range(0, static_cast<int>(Action::ACTION_COUNT) - 1));
   }
 
   return get_best_action(state);
@@ -87,6 +110,18 @@ void QLearningAgent::update(const State &state, Action action, float reward,
       learning_rate * (reward + discount_factor * max_next_q - current_q);
 
   q_table[state_key][static_cast<int>(action)] = new_q;
+
+  if (_planner) {
+    _planner->observe(*this, state, action, reward, next_state);
+  }
+}
+void QLearningAgent::enable_planning() {
+  if (!_planner) {
+    _planner = std::make_unique<DynaPlanner>();
+  }
+}
+uint32_t QLearningAgent::plan(std::chrono::steady_clock::time_point deadline) {
+  return _planner ? _planner->plan(*this, deadline) : 0;
 }
 
 float QLearningAgent::calculate_reward(float health_change,
@@ -95,12 +130,12 @@ float QLearningAgent::calculate_reward(float health_change,
                                        bool got_hit,
                                        float time_since_last_action,
                                        bool radar_in_range) {
+  const bool verbose = utils::Log::verbose();
   float reward = 0.0f;
 
-  const float OPTIMAL_COMBAT_DISTANCE = 120.0f;
-  const float CLOSE_RANGE = 80.0f;
-  const float MID_RANGE = 200.0f;
-  const float FAR_RANGE = 300.0f;
+  const float OPTIMAL_COMBAT_DISTANCE = _params.optimal_distance;
+  const float CLOSE_RANGE = _params.close_range;
+  const float FAR_RANGE = _params.far_range;
 
   float distance_reward = 0.0f;
   if (radar_in_range) {
@@ -112,84 +147,161 @@ float QLearningAgent::calculate_reward(float health_change,
 
     if (distance < CLOSE_RANGE) {
       distance_reward -= 1.0f;
-      std::cout << "⚠️ Too close for comfort! Distance penalty: -1.0"
-                << std::endl;
+      if (verbose)
+        std::cout << "⚠️ Too close for comfort! Distance penalty: -1.0"
+                  << std::endl;
     } else if (distance > FAR_RANGE) {
       distance_reward -= 2.0f;
-      std::cout << "⚠️ Too far to be effective! Distance penalty: -2.0"
-                << std::endl;
+      if (verbose)
+        std::cout << "⚠️ Too far to be effective! Distance penalty: -2.0"
+                  << std::endl;
     } else if (std::abs(distance - OPTIMAL_COMBAT_DISTANCE) < 20.0f) {
       distance_reward += 1.0f;
-      std::cout << "✨ Perfect combat range! Bonus: +1.0" << std::endl;
+      if (verbose)
+        std::cout << "✨ Perfect combat range! Bonus: +1.0" << std::endl;
     }
 
-    std::cout << "📏 Distance reward/penalty: " << distance_reward << std::endl;
+    if (verbose)
+      std::cout << "📏 Distance reward/penalty: " << distance_reward << std::endl;
   } else {
 
-    distance_reward = -3.0f;
-    std::cout << "🔍 Out of radar range penalty: -3.0" << std::endl;
+    distance_reward = -_params.out_of_radar_penalty;
+    if (verbose)
+      std::cout << "🔍 Out of radar range penalty: " << distance_reward
+                << std::endl;
   }
   reward += distance_reward;
 
-  static float previous_distance_deviation = std::numeric_limits<float>::max();
   float current_distance_deviation =
       std::abs(distance - OPTIMAL_COMBAT_DISTANCE);
 
-  if (previous_distance_deviation != std::numeric_limits<float>::max()) {
+  if (_previous_distance_deviation != std::numeric_limits<float>::max()) {
     float improvement =
-        previous_distance_deviation - current_distance_deviation;
+        _previous_distance_deviation - current_distance_deviation;
     if (improvement > 0) {
-      float improvement_reward = improvement * 0.5f;
+      float improvement_reward = improvement * _params.approach_reward;
       reward += improvement_reward;
-      std::cout << "⬆️ Moving toward optimal range: +" << improvement_reward
-                << std::endl;
+      if (verbose)
+        std::cout << "⬆️ Moving toward optimal range: +" << improvement_reward
+                  << std::endl;
     }
   }
-  previous_distance_deviation = current_distance_deviation;
+  _previous_distance_deviation = current_distance_deviation;
 
   if (hit_landed) {
 
-    float hit_reward = 5.0f;
+    float hit_reward = _params.hit_reward;
 
     if (std::abs(distance - OPTIMAL_COMBAT_DISTANCE) < 30.0f) {
       hit_reward *= 1.5f;
-      std::cout << "🎯 Perfect range hit bonus! Reward multiplier: 1.5x"
-                << std::endl;
+      if (verbose)
+        std::cout << "🎯 Perfect range hit bonus! Reward multiplier: 1.5x"
+                  << std::endl;
     }
 
     reward += hit_reward;
-    std::cout << "💥 Hit landed reward: +" << hit_reward << std::endl;
+    if (verbose)
+      std::cout << "💥 Hit landed reward: +" << hit_reward << std::endl;
   }
 
   if (got_hit) {
-    float defense_penalty = -4.0f;
+    float defense_penalty = -_params.got_hit_penalty;
     if (distance < CLOSE_RANGE) {
       defense_penalty *= 1.5f;
-      std::cout << "💔 Vulnerable position hit! Extra penalty applied"
-                << std::endl;
+      if (verbose)
+        std::cout << "💔 Vulnerable position hit! Extra penalty applied"
+                  << std::endl;
     }
     reward += defense_penalty;
-    std::cout << "💔 Got hit penalty: " << defense_penalty << std::endl;
+    if (verbose)
+      std::cout << "💔 Got hit penalty: " << defense_penalty << std::endl;
   }
 
   if (time_since_last_action > 0.5f) {
-    float inactivity_penalty = -0.3f * time_since_last_action;
+    float inactivity_penalty =
+        -_params.inactivity_penalty * time_since_last_action;
     if (!radar_in_range || distance > FAR_RANGE) {
       inactivity_penalty *= 2.0f;
-      std::cout << "⏰ Double inactivity penalty due to poor positioning"
-                << std::endl;
+      if (verbose)
+        std::cout << "⏰ Double inactivity penalty due to poor positioning"
+                  << std::endl;
     }
     reward += inactivity_penalty;
-    std::cout << "⏰ Inactivity penalty: " << inactivity_penalty << std::endl;
+    if (verbose)
+      std::cout << "⏰ Inactivity penalty: " << inactivity_penalty << std::endl;
   }
 
-  std::cout << "📊 Final reward calculation: " << reward << std::endl;
+  if (verbose)
+    std::cout << "📊 Final reward calculation: " << reward << std::endl;
   return reward;
 }
 
 void QLearningAgent::decay_exploration() {
 
-  exploration_rate = std::max(0.01f, exploration_rate * 0.995f);
+  exploration_rate = std::max(_params.min_exploration_rate,
+                              exploration_rate * _params.exploration_decay);
+}
+void QLearningAgent::save_table(const std::string &path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Failed to open Q-table: " + path);
+  }
+
+  QTableHeader header;
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (int index = 0; index < State::COUNT; ++index) {
+    auto entry = q_table.find(State::from_index(index).to_string());
+    if (entry == q_table.end()) {
+      continue;
+    }
+    const uint32_t state = static_cast<uint32_t>(index);
+    file.write(reinterpret_cast<const char *>(&state), sizeof(state));
+    file.write(reinterpret_cast<const char *>(entry->second.data()),
+               entry->second.size() * sizeof(float));
+  }
+  if (!file) {
+    throw std::runtime_error("Failed to write Q-table: " + path);
+  }
+}
+void QLearningAgent::load_table(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open Q-table: " + path);
+  }
+
+  const QTableHeader expected;
+  QTableHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || header.magic != expected.magic ||
+      header.version != expected.version ||
+      header.action_count != expected.action_count ||
+      header.state_count != expected.state_count) {
+    throw std::runtime_error("Not a Q-table: " + path);
+  }
+
+  q_table.clear();
+  uint32_t state;
+  std::vector<float> values(header.action_count);
+  while (file.read(reinterpret_cast<char *>(&state), sizeof(state)) &&
+         file.read(reinterpret_cast<char *>(values.data()),
+                   values.size() * sizeof(float))) {
+    if (state >= static_cast<uint32_t>(State::COUNT)) {
+      throw std::runtime_error("Corrupt Q-table: " + path);
+    }
+    set_q_values(State::from_index(static_cast<int>(state)), values.data());
+  }
+  exploration_rate = _params.min_exploration_rate;
+
+  std::cout << "Loaded " << q_table.size() << " states from " << path
+            << "\n";
+}
+void QLearningAgent::copy_table(const QLearningAgent &other) {
+  q_table = other.q_table;
+  exploration_rate = _params.min_exploration_rate;
+}
+void QLearningAgent::set_q_values(const State &state, const float *values) {
+  q_table[state.to_string()].assign(
+      values, values + static_cast<int>(Action::ACTION_COUNT));
 }
 float QLearningAgent::get_exploration_rate() const { return exploration_rate; }
 void QLearningAgent::log_action_selection(const State &state, Action action,
@@ -279,8 +391,8 @@ Action QLearningAgent::get_best_action(const State &state) {
   std::string state_key = state.to_string();
 
   if (q_table.find(state_key) == q_table.end()) {
-    return static_cast<Action>(std::uniform_int_distribution<int>(
-        0, static_cast<int>(Action::ACTION_COUNT) - 1)(rng));
+    return static_cast<Action>(
+        _random.range(0, static_cast<int>(Action::ACTION_COUNT) - 1));
   }
 
   const auto &q_values = q_table[state_key];
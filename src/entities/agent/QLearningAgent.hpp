@@ -1,8 +1,11 @@
 #pragma once
 #include "math/vector2.hpp"
+#include "utils/random.hpp"
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <iostream>
-#include <random>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -21,6 +24,28 @@ struct State {
   bool low_health;         // Is our health below 30%?
   bool opponent_in_radar;  // Is opponent currently in range?
 
+  // Dense numbering of every state: 5 bins per axis and three flags.
+  static constexpr int BINS = 5;
+  static constexpr int COUNT = BINS * BINS * BINS * 8;
+
+  int index() const {
+    return ((distance_bin * BINS + relative_x_bin) * BINS + relative_y_bin) *
+               8 +
+           (opponent_attacking | low_health << 1 | opponent_in_radar << 2);
+  }
+  static State from_index(int index) {
+    State state;
+    state.opponent_attacking = index & 1;
+    state.low_health = index & 2;
+    state.opponent_in_radar = index & 4;
+    index /= 8;
+    state.relative_y_bin = index % BINS;
+    index /= BINS;
+    state.relative_x_bin = index % BINS;
+    state.distance_bin = index / BINS;
+    return state;
+  }
+
   std::string to_string() const {
     return std::to_string(distance_bin) + "," + std::to_string(relative_x_bin) +
            "," + std::to_string(relative_y_bin) + "," +
@@ -44,10 +69,34 @@ enum class Action {
   ACTION_COUNT
 };
 
+// Learning and reward constants; the defaults are the values the agent was
+// tuned with.
+struct AgentParams {
+  float learning_rate = 0.1f;
+  float discount_factor = 0.95f;
+  float exploration_rate = 1.0f;
+  // Exploration is multiplied by this after every decision.
+  float exploration_decay = 0.995f;
+  float min_exploration_rate = 0.01f;
+
+  float optimal_distance = 120.0f;
+  float close_range = 80.0f;
+  float far_range = 300.0f;
+  // Per unit of distance closed toward the optimal distance.
+  float approach_reward = 0.5f;
+  float hit_reward = 5.0f;
+  float got_hit_penalty = 4.0f;
+  float out_of_radar_penalty = 3.0f;
+  // Per second since the last action, once idle for half a second.
+  float inactivity_penalty = 0.3f;
+};
+
+class DynaPlanner;
+
 class QLearningAgent {
 public:
-  QLearningAgent(float learning_rate = 0.1f, float discount_factor = 0.95f,
-                 float exploration_rate = 1.0f);
+  explicit QLearningAgent(const AgentParams &params = AgentParams());
+  ~QLearningAgent();
 
   State get_state(const Vector2f &agent_pos, const Vector2f &opponent_pos,
                   bool is_opponent_attacking, float health_percent);
@@ -63,24 +112,52 @@ public:
 
   void decay_exploration();
 
+  // Checkpoints of the Q-table: a 16-byte header, then the index and
+  // Q-values of every state in the table. Loading replaces the table and
+  // drops exploration to its floor, so the loaded policy is played.
+  void save_table(const std::string &path) const;
+  void load_table(const std::string &path);
+  void set_q_values(const State &state, const float *values);
+  // In-memory load_table().
+  void copy_table(const QLearningAgent &other);
+
+  // Dyna planning: update() also feeds a learned model, and plan() spends
+  // spare time on simulated updates from it. Returns the updates run.
+  void enable_planning();
+  bool is_planning() const { return _planner != nullptr; }
+  uint32_t plan(std::chrono::steady_clock::time_point deadline);
+
+  // Replaces the stream drawn at construction, for reproducible runs.
+  void seed(uint64_t seed, uint64_t stream) { _random.seed(seed, stream); }
+
   float get_exploration_rate() const;
+  // A greedy agent always plays its best known action: no exploration and
+  // none of select_action's random search and attack moves.
+  void set_greedy(bool greedy) { _greedy = greedy; }
+  const AgentParams &params() const { return _params; }
 
   void log_action_selection(const State &state, Action action, float q_value);
 
 private:
+  friend class DynaPlanner;
+
   std::string action_to_string(Action action) const;
 
   std::string state_to_string(const State &state) const;
 
 private:
+  AgentParams _params;
   float learning_rate;
   float discount_factor;
   float exploration_rate;
-  std::mt19937 rng;
+  bool _greedy = false;
+  utils::Random _random;
+  std::unique_ptr<DynaPlanner> _planner;
 
   int _recent_hits = 0;                 // For tracking combo multiplier
   float _last_known_distance = 0.0f;    // For tracking distance changes
   std::vector<float> _distance_history; // For calculating moving average
+  float _previous_distance_deviation = std::numeric_limits<float>::max();
 
   // New helper method to track distance trends
   void update_distance_history(float current_distance);
@@ -0,0 +1,116 @@
+#include "batch_trainer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace wbz {
+namespace ai {
+
+BatchQTrainer::BatchQTrainer(const BatchTrainerConfig &config)
+    : _config(config), _q(CELLS, 0.0f), _values(State::COUNT, 0.0f),
+      _visits(CELLS, 0), _sums(CHUNKS * CELLS, 0.0) {
+  // The pool's workers train alongside the calling thread.
+  const size_t threads =
+      config.threads ? config.threads
+                     : std::max(1u, std::thread::hardware_concurrency());
+  if (threads > 1) {
+    _pool.start(threads - 1);
+  }
+}
+
+void BatchQTrainer::add(const TrajectoryReader &reader) {
+  const auto &header = reader.header();
+  const TrajectoryRecord *records = reader.records();
+  _transitions.reserve(_transitions.size() + header.transition_count);
+
+  for (uint64_t i = 0; i < header.record_count; ++i) {
+    const TrajectoryRecord &record = records[i];
+    if (record.kind != TrajectoryRecord::TRANSITION ||
+        record.action >= ACTIONS) {
+      continue;
+    }
+
+    Transition transition;
+    transition.state = static_cast<uint16_t>(record.state.unpack().index());
+    transition.next_state =
+        static_cast<uint16_t>(record.next_state.unpack().index());
+    transition.action = record.action;
+    transition.terminal = record.terminal;
+    transition.reward = record.reward;
+    _transitions.push_back(transition);
+    ++_visits[transition.state * ACTIONS + transition.action];
+  }
+}
+
+BatchIteration BatchQTrainer::iterate() {
+  auto start = std::chrono::steady_clock::now();
+
+  for (int state = 0; state < State::COUNT; ++state) {
+    const float *q = &_q[state * ACTIONS];
+    _values[state] = *std::max_element(q, q + ACTIONS);
+  }
+
+  // Targets against the previous table, summed per chunk.
+  const size_t count = _transitions.size();
+  _pool.parallel_for(CHUNKS, [&](size_t chunk) {
+    double *sums = &_sums[chunk * CELLS];
+    std::fill(sums, sums + CELLS, 0.0);
+
+    const float discount = _config.discount_factor;
+    for (size_t i = chunk * count / CHUNKS; i < (chunk + 1) * count / CHUNKS;
+         ++i) {
+      const Transition &t = _transitions[i];
+      const float next = t.terminal ? 0.0f : _values[t.next_state];
+      sums[t.state * ACTIONS + t.action] += t.reward + discount * next;
+    }
+  });
+
+  // Reduce the chunks cell by cell, in chunk order.
+  float changes[CHUNKS] = {};
+  _pool.parallel_for(CHUNKS, [&](size_t block) {
+    for (size_t cell = block * CELLS / CHUNKS;
+         cell < (block + 1) * CELLS / CHUNKS; ++cell) {
+      if (_visits[cell] == 0) {
+        continue;
+      }
+      double total = 0.0;
+      for (size_t chunk = 0; chunk < CHUNKS; ++chunk) {
+        total += _sums[chunk * CELLS + cell];
+      }
+      const float target = static_cast<float>(total / _visits[cell]);
+      const float change = _config.learning_rate * (target - _q[cell]);
+      _q[cell] += change;
+      changes[block] = std::max(changes[block], std::fabs(change));
+    }
+  });
+
+  BatchIteration iteration;
+  iteration.max_change = *std::max_element(changes, changes + CHUNKS);
+  iteration.seconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  return iteration;
+}
+
+uint32_t BatchQTrainer::train() {
+  for (uint32_t i = 0; i < _config.iterations; ++i) {
+    if (iterate().max_change <= _config.tolerance) {
+      return i + 1;
+    }
+  }
+  return _config.iterations;
+}
+
+void BatchQTrainer::export_to(QLearningAgent &agent) const {
+  for (int state = 0; state < State::COUNT; ++state) {
+    const uint32_t *visits = &_visits[state * ACTIONS];
+    if (std::any_of(visits, visits + ACTIONS,
+                    [](uint32_t count) { return count > 0; })) {
+      agent.set_q_values(State::from_index(state), &_q[state * ACTIONS]);
+    }
+  }
+}
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "QLearningAgent.hpp"
+#include "trajectory_log.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wbz {
+namespace ai {
+
+struct BatchTrainerConfig {
+  float discount_factor = 0.95f;
+  // 1 is plain fitted Q-iteration: every visited Q-value becomes the mean
+  // of its targets.
+  float learning_rate = 1.0f;
+  uint32_t iterations = 100;
+  // Stops once no Q-value moves by more than this in an iteration.
+  float tolerance = 1e-4f;
+  // 1 trains on the calling thread, 0 uses every core.
+  size_t threads = 0;
+};
+
+struct BatchIteration {
+  float max_change = 0.0f;
+  double seconds = 0.0;
+};
+
+// Offline tabular fitted Q-iteration over recorded transitions. Each
+// iteration computes every transition's target against the previous
+// table, summing targets per state and action into per-chunk dense tables
+// that are then reduced in chunk order. The dataset is split into a fixed
+// number of chunks, so results do not depend on the thread count.
+class BatchQTrainer {
+public:
+  explicit BatchQTrainer(const BatchTrainerConfig &config);
+
+  // Copies the log's transitions into the dataset.
+  void add(const TrajectoryReader &reader);
+  size_t transitions() const { return _transitions.size(); }
+
+  BatchIteration iterate();
+  // Iterates until converged or out of iterations; returns the iterations
+  // run.
+  uint32_t train();
+
+  // Writes the Q-values of every state the dataset visits.
+  void export_to(QLearningAgent &agent) const;
+
+private:
+  static constexpr int ACTIONS = static_cast<int>(Action::ACTION_COUNT);
+  static constexpr int CELLS = State::COUNT * ACTIONS;
+  static constexpr size_t CHUNKS = 64;
+
+  struct Transition {
+    uint16_t state;
+    uint16_t next_state;
+    uint8_t action;
+    uint8_t terminal;
+    float reward;
+  };
+
+  BatchTrainerConfig _config;
+  std::vector<Transition> _transitions;
+  std::vector<float> _q;
+  std::vector<float> _values;
+  std::vector<uint32_t> _visits;
+  std::vector<double> _sums;
+  utils::ThreadPool _pool;
+};
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace wbz {
+namespace ai {
+
+// Paces AI decisions for a group of agents. Each agent decides once every
+// interval() ticks and repeats its action in between; agents get staggered
+// phases so about 1/interval of them decide on any tick. A non-zero budget
+// caps the decisions per tick, and agents over it retry on the next tick.
+class DecisionScheduler {
+public:
+  explicit DecisionScheduler(uint32_t interval = 1, uint32_t budget = 0)
+      : _interval(std::max(1u, interval)), _budget(budget) {}
+
+  uint32_t interval() const { return _interval; }
+  uint32_t budget() const { return _budget; }
+
+  // Ticks a newly scheduled agent waits before its first decision.
+  uint32_t next_phase() { return _agents++ % _interval; }
+
+  void begin_tick() { _decisions = 0; }
+
+  // Claims a decision from this tick's budget.
+  bool acquire() {
+    if (_budget && _decisions >= _budget) {
+      ++_deferred;
+      return false;
+    }
+    ++_decisions;
+    ++_total;
+    return true;
+  }
+
+  uint64_t decisions() const { return _total; }
+  uint64_t deferred() const { return _deferred; }
+
+private:
+  uint32_t _interval;
+  uint32_t _budget;
+  uint32_t _agents = 0;
+  uint32_t _decisions = 0;
+  uint64_t _total = 0;
+  uint64_t _deferred = 0;
+};
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,111 @@
+#include "dyna_planner.hpp"
+#include <cmath>
+#include <string>
+
+namespace wbz {
+namespace ai {
+
+namespace {
+// Q-table keys of every state, built once.
+const std::string &state_key(int state) {
+  static const std::vector<std::string> keys = [] {
+    std::vector<std::string> keys(State::COUNT);
+    for (int i = 0; i < State::COUNT; ++i) {
+      keys[i] = State::from_index(i).to_string();
+    }
+    return keys;
+  }();
+  return keys[state];
+}
+
+// Planning checks the clock once per this many updates.
+constexpr uint32_t DEADLINE_CHECK_INTERVAL = 16;
+} // namespace
+
+DynaPlanner::DynaPlanner()
+    : _visits(CELLS, 0), _reward_sums(CELLS, 0.0f), _outcomes(CELLS),
+      _predecessors(State::COUNT), _queued_priority(CELLS, 0.0f) {}
+
+void DynaPlanner::observe(QLearningAgent &agent, const State &state,
+                          Action action, float reward,
+                          const State &next_state) {
+  const int cell = state.index() * ACTIONS + static_cast<int>(action);
+  const uint16_t next = static_cast<uint16_t>(next_state.index());
+
+  ++_visits[cell];
+  _reward_sums[cell] += reward;
+
+  auto &outcomes = _outcomes[cell];
+  bool seen = false;
+  for (auto &outcome : outcomes) {
+    if (outcome.next_state == next) {
+      ++outcome.count;
+      seen = true;
+      break;
+    }
+  }
+  if (!seen) {
+    outcomes.push_back({next, 1});
+    _predecessors[next].push_back(static_cast<uint16_t>(cell));
+  }
+
+  const float q = agent.get_q_value(state_key(cell / ACTIONS), action);
+  push(cell, std::fabs(expected_target(agent, cell) - q));
+}
+
+uint32_t DynaPlanner::plan(QLearningAgent &agent,
+                           std::chrono::steady_clock::time_point deadline) {
+  uint32_t updates = 0;
+  while (!_queue.empty()) {
+    if (updates % DEADLINE_CHECK_INTERVAL == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+
+    const auto entry = _queue.top();
+    _queue.pop();
+    const int cell = entry.second;
+    if (entry.first != _queued_priority[cell]) {
+      continue; // superseded by a later push
+    }
+    _queued_priority[cell] = 0.0f;
+
+    const int state = cell / ACTIONS;
+    const Action action = static_cast<Action>(cell % ACTIONS);
+    const std::string &key = state_key(state);
+    const float q = agent.get_q_value(key, action);
+    agent.q_table[key][cell % ACTIONS] =
+        q + agent.learning_rate * (expected_target(agent, cell) - q);
+    ++updates;
+
+    for (uint16_t predecessor : _predecessors[state]) {
+      const float predecessor_q =
+          agent.get_q_value(state_key(predecessor / ACTIONS),
+                            static_cast<Action>(predecessor % ACTIONS));
+      push(predecessor,
+           std::fabs(expected_target(agent, predecessor) - predecessor_q));
+    }
+  }
+  return updates;
+}
+
+float DynaPlanner::expected_target(QLearningAgent &agent, int cell) const {
+  const float visits = static_cast<float>(_visits[cell]);
+  float next_value = 0.0f;
+  for (const auto &outcome : _outcomes[cell]) {
+    next_value += outcome.count / visits *
+                  agent.get_max_q_value(state_key(outcome.next_state));
+  }
+  return _reward_sums[cell] / visits + agent.discount_factor * next_value;
+}
+
+void DynaPlanner::push(int cell, float priority) {
+  if (priority < PRIORITY_THRESHOLD || priority <= _queued_priority[cell]) {
+    return;
+  }
+  _queued_priority[cell] = priority;
+  _queue.push({priority, static_cast<uint16_t>(cell)});
+}
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "QLearningAgent.hpp"
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace wbz {
+namespace ai {
+
+// Dyna-style planning for QLearningAgent: a tabular model of the rewards
+// and next states seen after every state and action, and a prioritized
+// sweeping queue of the Q-values the model says are furthest from their
+// expected targets. Planning updates pop the queue until a deadline, then
+// requeue the predecessors of the state they changed.
+class DynaPlanner {
+public:
+  // Queue entries smaller than this are dropped.
+  static constexpr float PRIORITY_THRESHOLD = 1e-3f;
+
+  DynaPlanner();
+
+  // Folds a real transition into the model and queues its Q-value.
+  void observe(QLearningAgent &agent, const State &state, Action action,
+               float reward, const State &next_state);
+
+  // Runs planning updates until the queue empties or the deadline passes;
+  // returns how many ran.
+  uint32_t plan(QLearningAgent &agent,
+                std::chrono::steady_clock::time_point deadline);
+
+  size_t queued() const { return _queue.size(); }
+
+private:
+  static constexpr int ACTIONS = static_cast<int>(Action::ACTION_COUNT);
+  static constexpr int CELLS = State::COUNT * ACTIONS;
+
+  struct Outcome {
+    uint16_t next_state;
+    uint32_t count;
+  };
+
+  std::vector<uint32_t> _visits;
+  std::vector<float> _reward_sums;
+  std::vector<std::vector<Outcome>> _outcomes;
+  // State and action cells that have led to each state.
+  std::vector<std::vector<uint16_t>> _predecessors;
+
+  std::priority_queue<std::pair<float, uint16_t>> _queue;
+  // Priority each cell is queued with, 0 when it is not queued.
+  std::vector<float> _queued_priority;
+
+  // Expected one-step target of a cell under the model.
+  float expected_target(QLearningAgent &agent, int cell) const;
+  void push(int cell, float priority);
+};
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,261 @@
+#include "trajectory_log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wbz {
+namespace ai {
+
+namespace {
+size_t file_size(uint64_t records) {
+  return sizeof(TrajectoryHeader) + records * sizeof(TrajectoryRecord);
+}
+
+void store(uint64_t *word, uint64_t value) {
+  __atomic_store_n(word, value, __ATOMIC_RELEASE);
+}
+} // namespace
+
+PackedState PackedState::pack(const State &state) {
+  PackedState packed;
+  packed.distance_bin = static_cast<int16_t>(state.distance_bin);
+  packed.relative_x_bin = static_cast<int16_t>(state.relative_x_bin);
+  packed.relative_y_bin = static_cast<int16_t>(state.relative_y_bin);
+  packed.flags = static_cast<uint16_t>(state.opponent_attacking |
+                                       state.low_health << 1 |
+                                       state.opponent_in_radar << 2);
+  return packed;
+}
+
+State PackedState::unpack() const {
+  State state;
+  state.distance_bin = distance_bin;
+  state.relative_x_bin = relative_x_bin;
+  state.relative_y_bin = relative_y_bin;
+  state.opponent_attacking = flags & 1;
+  state.low_health = flags & 2;
+  state.opponent_in_radar = flags & 4;
+  return state;
+}
+
+void TrajectoryWriter::open(const std::string &path, uint64_t seed) {
+  close();
+
+  _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (_fd < 0) {
+    throw std::runtime_error("Failed to open trajectory log: " + path);
+  }
+  _path = path;
+  map(GROW_RECORDS);
+
+  *_header = TrajectoryHeader();
+  _header->seed = seed;
+  _synced = 0;
+  _episode_first = 0;
+  _episode_length = 0;
+  _episode_reward = 0.0f;
+
+  std::cout << "Recording trajectories to " << path << "\n";
+}
+
+void TrajectoryWriter::append(const State &state, Action action, float reward,
+                              const State &next_state) {
+  if (!_header) {
+    return;
+  }
+
+  auto *record = static_cast<TrajectoryRecord *>(next_record());
+  record->kind = TrajectoryRecord::TRANSITION;
+  record->action = static_cast<uint8_t>(action);
+  record->terminal = 0;
+  record->reserved = 0;
+  record->reward = reward;
+  record->episode = static_cast<uint32_t>(_header->episode_count);
+  record->step = _episode_length;
+  record->state = PackedState::pack(state);
+  record->next_state = PackedState::pack(next_state);
+
+  if (_episode_length == 0) {
+    _episode_first = _header->record_count;
+  }
+  ++_episode_length;
+  _episode_reward += reward;
+  store(&_header->transition_count, _header->transition_count + 1);
+  commit_record();
+}
+
+void TrajectoryWriter::end_episode(bool terminal) {
+  if (!_header || _episode_length == 0) {
+    return;
+  }
+
+  records()[_header->record_count - 1].terminal = terminal;
+
+  const uint64_t index = _header->record_count;
+  auto *episode = static_cast<EpisodeRecord *>(next_record());
+  episode->kind = TrajectoryRecord::EPISODE;
+  episode->terminal = terminal;
+  episode->reserved = 0;
+  episode->episode = static_cast<uint32_t>(_header->episode_count);
+  episode->first_record = _episode_first;
+  episode->length = _episode_length;
+  episode->total_reward = _episode_reward;
+  episode->previous_episode = _header->last_episode;
+
+  _episode_length = 0;
+  _episode_reward = 0.0f;
+  store(&_header->last_episode, index);
+  store(&_header->episode_count, _header->episode_count + 1);
+  commit_record();
+}
+
+void TrajectoryWriter::close() {
+  if (!_header) {
+    return;
+  }
+
+  end_episode(false);
+  const uint64_t count = _header->record_count;
+  const uint64_t transitions = _header->transition_count;
+  const uint64_t episodes = _header->episode_count;
+  sync(MS_SYNC);
+  munmap(_header, file_size(_capacity));
+  _header = nullptr;
+
+  if (ftruncate(_fd, static_cast<off_t>(file_size(count))) != 0) {
+    std::cerr << "Failed to trim trajectory log " << _path << "\n";
+  }
+  ::close(_fd);
+  _fd = -1;
+
+  std::cout << "Recorded " << transitions << " transitions in " << episodes
+            << " episodes to " << _path << "\n";
+}
+
+uint64_t TrajectoryWriter::transitions() const {
+  return _header ? _header->transition_count : 0;
+}
+
+uint64_t TrajectoryWriter::episodes() const {
+  return _header ? _header->episode_count : 0;
+}
+
+TrajectoryRecord *TrajectoryWriter::records() const {
+  return reinterpret_cast<TrajectoryRecord *>(_header + 1);
+}
+
+void *TrajectoryWriter::next_record() {
+  if (_header->record_count == _capacity) {
+    map(_capacity + std::max(_capacity, GROW_RECORDS));
+  }
+  return records() + _header->record_count;
+}
+
+// Publishes the record written at next_record() to readers of the mapping.
+void TrajectoryWriter::commit_record() {
+  const uint64_t count = _header->record_count + 1;
+  store(&_header->record_count, count);
+  if (count - _synced >= SYNC_RECORDS) {
+    sync(MS_ASYNC);
+  }
+}
+
+void TrajectoryWriter::map(uint64_t capacity) {
+  if (_header) {
+    sync(MS_ASYNC);
+    munmap(_header, file_size(_capacity));
+    _header = nullptr;
+  }
+
+  if (ftruncate(_fd, static_cast<off_t>(file_size(capacity))) != 0) {
+    throw std::runtime_error("Failed to grow trajectory log: " + _path);
+  }
+  void *memory = mmap(nullptr, file_size(capacity), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, _fd, 0);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error("Failed to map trajectory log: " + _path);
+  }
+  _header = static_cast<TrajectoryHeader *>(memory);
+  _capacity = capacity;
+}
+
+// Flushes the pages written since the last sync, and the header.
+void TrajectoryWriter::sync(int flags) {
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const uint64_t count = _header->record_count;
+  const size_t begin = file_size(_synced) / page * page;
+  const size_t end = file_size(count);
+  auto *base = reinterpret_cast<uint8_t *>(_header);
+
+  msync(base, page, flags);
+  if (end > begin) {
+    msync(base + begin, end - begin, flags);
+  }
+  _synced = count;
+}
+
+void TrajectoryReader::open(const std::string &path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open trajectory log: " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      static_cast<size_t>(info.st_size) < sizeof(TrajectoryHeader)) {
+    ::close(fd);
+    throw std::runtime_error("Not a trajectory log: " + path);
+  }
+
+  _size = static_cast<size_t>(info.st_size);
+  void *memory = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error("Failed to map trajectory log: " + path);
+  }
+  _header = static_cast<const TrajectoryHeader *>(memory);
+
+  if (_header->magic != TrajectoryHeader::MAGIC ||
+      _header->version != TrajectoryHeader::VERSION ||
+      _header->record_size != sizeof(TrajectoryRecord) ||
+      file_size(_header->record_count) > _size) {
+    close();
+    throw std::runtime_error("Not a trajectory log: " + path);
+  }
+  // Sequential passes are the common case for training.
+  madvise(const_cast<TrajectoryHeader *>(_header), _size, MADV_SEQUENTIAL);
+}
+
+void TrajectoryReader::close() {
+  if (_header) {
+    munmap(const_cast<TrajectoryHeader *>(_header), _size);
+    _header = nullptr;
+  }
+}
+
+std::vector<EpisodeRecord> TrajectoryReader::episodes() const {
+  std::vector<EpisodeRecord> episodes;
+  episodes.reserve(_header->episode_count);
+  for (uint64_t index = _header->last_episode;
+       index != TrajectoryHeader::NONE && index < _header->record_count;) {
+    EpisodeRecord episode;
+    std::memcpy(&episode, records() + index, sizeof(episode));
+    episodes.push_back(episode);
+    if (episode.previous_episode != TrajectoryHeader::NONE &&
+        episode.previous_episode >= index) {
+      break;
+    }
+    index = episode.previous_episode;
+  }
+  std::reverse(episodes.begin(), episodes.end());
+  return episodes;
+}
+
+} // namespace ai
+} // namespace wbz
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "QLearningAgent.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wbz {
+namespace ai {
+
+// Append-only trajectory file for offline learning: a 64-byte header, then
+// 32-byte records. An episode is a contiguous run of transition records
+// closed by one episode record, which points back at the previous episode
+// record so readers can index the file without scanning it.
+struct PackedState {
+  int16_t distance_bin;
+  int16_t relative_x_bin;
+  int16_t relative_y_bin;
+  uint16_t flags; // opponent_attacking, low_health, opponent_in_radar
+
+  static PackedState pack(const State &state);
+  State unpack() const;
+};
+static_assert(sizeof(PackedState) == 8, "PackedState is padded");
+
+struct TrajectoryHeader {
+  static constexpr uint32_t MAGIC = 0x545a4257; // "WBZT"
+  static constexpr uint16_t VERSION = 1;
+  static constexpr uint64_t NONE = ~0ull;
+
+  uint32_t magic = MAGIC;
+  uint16_t version = VERSION;
+  uint16_t record_size = 32;
+  uint64_t seed = 0;
+  // Records written so far, transitions and episode records alike.
+  uint64_t record_count = 0;
+  uint64_t transition_count = 0;
+  uint64_t episode_count = 0;
+  uint64_t last_episode = NONE;
+  uint64_t reserved[2] = {};
+};
+static_assert(sizeof(TrajectoryHeader) == 64, "TrajectoryHeader is padded");
+
+struct TrajectoryRecord {
+  enum Kind : uint8_t { TRANSITION, EPISODE };
+
+  uint8_t kind;
+  uint8_t action;
+  // The transition ended its episode on a defeat.
+  uint8_t terminal;
+  uint8_t reserved;
+  float reward;
+  uint32_t episode;
+  uint32_t step;
+  PackedState state;
+  PackedState next_state;
+};
+static_assert(sizeof(TrajectoryRecord) == 32, "TrajectoryRecord is padded");
+
+struct EpisodeRecord {
+  uint8_t kind; // TrajectoryRecord::EPISODE
+  uint8_t terminal;
+  uint16_t reserved;
+  uint32_t episode;
+  uint64_t first_record;
+  uint32_t length;
+  float total_reward;
+  uint64_t previous_episode;
+};
+static_assert(sizeof(EpisodeRecord) == 32, "EpisodeRecord is padded");
+
+// Writes transitions straight into a memory-mapped file. Appending is a
+// store into the mapping; the only syscalls are growing the file every
+// GROW_RECORDS records and an asynchronous msync every SYNC_RECORDS.
+class TrajectoryWriter {
+public:
+  static constexpr uint64_t GROW_RECORDS = 1 << 16;
+  static constexpr uint64_t SYNC_RECORDS = 1 << 14;
+
+  TrajectoryWriter() = default;
+  ~TrajectoryWriter() { close(); }
+  TrajectoryWriter(const TrajectoryWriter &) = delete;
+  TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+
+  void open(const std::string &path, uint64_t seed);
+  bool is_open() const { return _header != nullptr; }
+
+  void append(const State &state, Action action, float reward,
+              const State &next_state);
+  // Closes the running episode, if it has any transitions.
+  void end_episode(bool terminal);
+
+  // Ends the running episode, syncs and trims the file to its records.
+  void close();
+
+  uint64_t transitions() const;
+  uint64_t episodes() const;
+
+private:
+  int _fd = -1;
+  TrajectoryHeader *_header = nullptr;
+  uint64_t _capacity = 0;
+  uint64_t _synced = 0;
+  std::string _path;
+
+  uint64_t _episode_first = 0;
+  uint32_t _episode_length = 0;
+  float _episode_reward = 0.0f;
+
+  TrajectoryRecord *records() const;
+  void *next_record();
+  void commit_record();
+  void map(uint64_t capacity);
+  void sync(int flags);
+};
+
+// Read-only mapping of a trajectory file.
+class TrajectoryReader {
+public:
+  TrajectoryReader() = default;
+  ~TrajectoryReader() { close(); }
+  TrajectoryReader(const TrajectoryReader &) = delete;
+  TrajectoryReader &operator=(const TrajectoryReader &) = delete;
+
+  void open(const std::string &path);
+  void close();
+
+  const TrajectoryHeader &header() const { return *_header; }
+  const TrajectoryRecord *records() const {
+    return reinterpret_cast<const TrajectoryRecord *>(_header + 1);
+  }
+
+  // Episode records in the order they were written.
+  std::vector<EpisodeRecord> episodes() const;
+
+private:
+  const TrajectoryHeader *_header = nullptr;
+  size_t _size = 0;
+};
+
+} // namespace ai
+} // namespace wbz
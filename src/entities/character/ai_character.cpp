@@ -1,4 +1,5 @@
 #include "ai_character.hpp"
+#include "utils/log.hpp"
 #include <cmath>
 #include <iostream>
 
@@ -21,35 +22,32 @@ void AICharacter::update(double delta_time) {
     // Expand the radar
     if (_radar_radius < _max_radar_radius) {
       _radar_radius += _radar_expand_speed * static_cast<float>(delta_time);
-      std::cout << "[Episode: " << _training_episode
-                << "][Radar] Expanding radius -> " << _radar_radius
-                << std::endl;
+      if (utils::Log::verbose())
+        std::cout << "[Episode: " << _training_episode
+                  << "][Radar] Expanding radius -> " << _radar_radius
+                  << std::endl;
     }
   } else {
 
     _radar_radius = std::max(_radar_radius - 10.0f * (float)delta_time, 50.0f);
-    std::cout << "[Episode: " << _training_episode
-              << "][Radar] Opponent found! Radar shrinking -> " << _radar_radius
-              << std::endl;
+    if (utils::Log::verbose())
+      std::cout << "[Episode: " << _training_episode
+                << "][Radar] Opponent found! Radar shrinking -> "
+                << _radar_radius << std::endl;
   }
 
   if (_episode_timer <= 0.0f) {
     _training_episode++;
-    std::cout << "\n=== Training Episode " << _training_episode << " ===\n"
-              << "AI Health: " << state().health << "/" << state().max_health
-              << "\nOpponent Health: " << _opponent->state().health << "/"
-              << _opponent->state().max_health << std::endl;
+    if (utils::Log::verbose())
+      std::cout << "\n=== Training Episode " << _training_episode << " ===\n"
+                << "AI Health: " << state().health << "/" << state().max_health
+                << "\nOpponent Health: " << _opponent->state().health << "/"
+                << _opponent->state().max_health << std::endl;
     _episode_timer = 5.0f;
+    end_trajectory_episode(false);
   }
   _episode_timer -= static_cast<float>(delta_time);
 
-  auto current_state = ai_agent->get_state(
-      mover().position(), _opponent->mover().position(),
-      _opponent->get_combat_state() == CombatState::ATTACKING,
-      static_cast<float>(state().health) / state().max_health);
-
-  current_state.opponent_in_radar = in_radar;
-
   float health_change = _previous_health - state().health;
   float opponent_health_change =
       _previous_opponent_health - _opponent->state().health;
@@ -61,30 +59,99 @@ void AICharacter::update(double delta_time) {
       health_change, opponent_health_change, distance, _hit_landed, _got_hit,
       _time_since_last_action, in_radar);
 
+  _last_reward = reward;
+  _decision_reward += reward;
+  _previous_health = state().health;
+  _previous_opponent_health = _opponent->state().health;
+  _hit_landed = false;
+  _got_hit = false;
+
+  if (is_decision_tick()) {
+    decide(in_radar);
+  }
   if (_has_previous_state) {
-    ai_agent->update(_previous_state, _previous_action, reward, current_state);
+    execute_action(_previous_action);
   }
 
-  auto action = ai_agent->select_action(current_state);
-  execute_action(action);
+  Character::update(delta_time);
+}
+
+// Observes the state and picks the action to repeat until the next
+// decision, learning from the reward gathered since the last one.
+void AICharacter::decide(bool in_radar) {
+  auto current_state = ai_agent->get_state(
+      mover().position(), _opponent->mover().position(),
+      _opponent->get_combat_state() == CombatState::ATTACKING,
+      static_cast<float>(state().health) / state().max_health);
+
+  current_state.opponent_in_radar = in_radar;
+
+  if (_trajectory && _has_previous_state && !_trajectory_split) {
+    _trajectory->append(_previous_state, _previous_action, _decision_reward,
+                        current_state);
+  }
+  _trajectory_split = false;
+
+  ai::Action action = _external_action;
+  if (!_external_control) {
+    if (_learning && _has_previous_state) {
+      ai_agent->update(_previous_state, _previous_action, _decision_reward,
+                       current_state);
+    }
+    action = ai_agent->select_action(current_state);
+    if (_learning) {
+      ai_agent->decay_exploration();
+    }
+  }
 
   _previous_state = current_state;
   _previous_action = action;
   _has_previous_state = true;
-  _previous_health = state().health;
-  _previous_opponent_health = _opponent->state().health;
-  _hit_landed = false;
-  _got_hit = false;
-  ai_agent->decay_exploration();
+  // Externally controlled characters decide every tick; their attacks are
+  // armed once per set_action() instead.
+  if (!_external_control) {
+    _attack_pending = true;
+  }
+  _decision_reward = 0.0f;
+}
 
-  Character::update(delta_time);
+// Externally controlled characters follow set_action() every tick.
+bool AICharacter::is_decision_tick() {
+  if (_external_control) {
+    return true;
+  }
+  if (_ticks_until_decision > 0) {
+    --_ticks_until_decision;
+    return false;
+  }
+  if (_scheduler && !_scheduler->acquire()) {
+    return false;
+  }
+  _ticks_until_decision = _decision_interval - 1;
+  return true;
+}
+
+void AICharacter::set_decision_scheduler(ai::DecisionScheduler *scheduler) {
+  _scheduler = scheduler;
+  _decision_interval = scheduler ? scheduler->interval() : 1;
+  _ticks_until_decision = scheduler ? scheduler->next_phase() : 0;
 }
 
-void AICharacter::render(SDL_Renderer *renderer) const {
+void AICharacter::snapshot(RenderSnapshot &snapshot) const {
 
-  Character::render(renderer);
+  Character::snapshot(snapshot);
+
+  snapshot_radar(snapshot);
+}
 
-  draw_radar(renderer);
+void AICharacter::hash_state(utils::Hash &hash) const {
+  Character::hash_state(hash);
+  hash.add(_radar_radius);
+  hash.add(_time_since_last_action);
+  hash.add(_episode_timer);
+  hash.add(ai_agent->get_exploration_rate());
+  hash.add(_ticks_until_decision);
+  hash.add(_decision_reward);
 }
 
 bool AICharacter::is_opponent_in_radar() const {
@@ -95,77 +162,62 @@ bool AICharacter::is_opponent_in_radar() const {
   return dist <= _radar_radius;
 }
 
-void AICharacter::draw_radar(SDL_Renderer *renderer) const {
+void AICharacter::snapshot_radar(RenderSnapshot &snapshot) const {
 
-  Vector2f center = mover().position();
-  int segments = 60;
-  float angle_step =
-      2.0f * static_cast<float>(M_PI) / static_cast<float>(segments);
-
-  SDL_SetRenderDrawColor(renderer, 255, 255, 0, 128);
-
-  for (int i = 0; i < segments; i++) {
-    float angle1 = i * angle_step;
-    float angle2 = (i + 1) * angle_step;
-
-    float x1 = center.x + _radar_radius * std::cos(angle1);
-    float y1 = center.y + _radar_radius * std::sin(angle1);
-    float x2 = center.x + _radar_radius * std::cos(angle2);
-    float y2 = center.y + _radar_radius * std::sin(angle2);
-
-    SDL_RenderDrawLine(renderer, static_cast<int>(x1), static_cast<int>(y1),
-                       static_cast<int>(x2), static_cast<int>(y2));
-  }
+  snapshot.debug.circle(DebugCategory::RADAR, mover().position(),
+                        _radar_radius, {255, 255, 0, 128});
 
   if (is_opponent_in_radar() && _opponent) {
-    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
     int x1 = (int)mover().position().x;
     int y1 = (int)mover().position().y;
     int x2 = (int)_opponent->mover().position().x;
     int y2 = (int)_opponent->mover().position().y;
-    SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+    snapshot.debug.line(DebugCategory::RADAR, x1, y1, x2, y2,
+                        {255, 255, 0, 255});
   }
 }
 
 void AICharacter::execute_action(ai::Action action) {
   _time_since_last_action = 0.0f;
 
-  std::string action_name;
-  // TODO: refactor this into a function
-  switch (action) {
-  case ai::Action::MOVE_LEFT:
-    action_name = "MOVE_LEFT";
-    break;
-  case ai::Action::MOVE_RIGHT:
-    action_name = "MOVE_RIGHT";
-    break;
-  case ai::Action::MOVE_UP:
-    action_name = "MOVE_UP";
-    break;
-  case ai::Action::MOVE_DOWN:
-    action_name = "MOVE_DOWN";
-    break;
-  case ai::Action::LIGHT_PUNCH:
-    action_name = "LIGHT_PUNCH";
-    break;
-  case ai::Action::HEAVY_PUNCH:
-    action_name = "HEAVY_PUNCH";
-    break;
-  case ai::Action::LIGHT_KICK:
-    action_name = "LIGHT_KICK";
-    break;
-  case ai::Action::HEAVY_KICK:
-    action_name = "HEAVY_KICK";
-    break;
-  case ai::Action::BLOCK:
-    action_name = "BLOCK";
-    break;
-  case ai::Action::IDLE:
-    action_name = "IDLE";
-    break;
-  }
+  if (utils::Log::verbose()) {
+    std::string action_name;
+    // TODO: refactor this into a function
+    switch (action) {
+    case ai::Action::MOVE_LEFT:
+      action_name = "MOVE_LEFT";
+      break;
+    case ai::Action::MOVE_RIGHT:
+      action_name = "MOVE_RIGHT";
+      break;
+    case ai::Action::MOVE_UP:
+      action_name = "MOVE_UP";
+      break;
+    case ai::Action::MOVE_DOWN:
+      action_name = "MOVE_DOWN";
+      break;
+    case ai::Action::LIGHT_PUNCH:
+      action_name = "LIGHT_PUNCH";
+      break;
+    case ai::Action::HEAVY_PUNCH:
+      action_name = "HEAVY_PUNCH";
+      break;
+    case ai::Action::LIGHT_KICK:
+      action_name = "LIGHT_KICK";
+      break;
+    case ai::Action::HEAVY_KICK:
+      action_name = "HEAVY_KICK";
+      break;
+    case ai::Action::BLOCK:
+      action_name = "BLOCK";
+      break;
+    case ai::Action::IDLE:
+      action_name = "IDLE";
+      break;
+    }
 
-  std::cout << "[AI Action] " << action_name << std::endl;
+    std::cout << "[AI Action] " << action_name << std::endl;
+  }
 
   // TODO: this amount should be decided by the agent
   const float MOVEMENT_FORCE = 5000.0f;
@@ -184,16 +236,16 @@ void AICharacter::execute_action(ai::Action action) {
     mover().add_force(Vector2f(0.0f, MOVEMENT_FORCE));
     break;
   case ai::Action::LIGHT_PUNCH:
-    perform_attack("light_punch");
+    start_attack("light_punch");
     break;
   case ai::Action::HEAVY_PUNCH:
-    perform_attack("heavy_punch");
+    start_attack("heavy_punch");
     break;
   case ai::Action::LIGHT_KICK:
-    perform_attack("light_kick");
+    start_attack("light_kick");
     break;
   case ai::Action::HEAVY_KICK:
-    perform_attack("heavy_kick");
+    start_attack("heavy_kick");
     break;
   case ai::Action::BLOCK:
     set_combat_state(CombatState::BLOCKING);
@@ -204,9 +256,20 @@ void AICharacter::execute_action(ai::Action action) {
   }
 }
 
+// Movement and blocking repeat every tick of a decision, but an attack
+// decision starts one attack, as soon as the character can attack.
+void AICharacter::start_attack(const char *attack) {
+  if (_attack_pending && can_attack() && perform_attack(attack)) {
+    _attack_pending = false;
+  }
+}
+
 void AICharacter::start_new_episode() {
   _training_episode++;
-  log_episode_start();
+  if (_episode_logging)
+    log_episode_start();
+  end_trajectory_episode(false);
+  _decision_reward = 0.0f;
   reset();
 }
 void AICharacter::set_opponent(Character *opponent) {
@@ -215,7 +278,16 @@ void AICharacter::set_opponent(Character *opponent) {
 }
 void AICharacter::handle_defeat() {
   Character::handle_defeat();
-  log_episode_end();
+  if (_episode_logging)
+    log_episode_end();
+  end_trajectory_episode(true);
+}
+void AICharacter::end_trajectory_episode(bool terminal) {
+  if (!_trajectory) {
+    return;
+  }
+  _trajectory->end_episode(terminal);
+  _trajectory_split = true;
 }
 void AICharacter::log_combat_event(const std::string &event_type,
                                    const std::string &details) {
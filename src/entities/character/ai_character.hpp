@@ -1,6 +1,9 @@
 #pragma once
 #include "character.hpp"
 #include "entities/agent/QLearningAgent.hpp"
+#include "entities/agent/decision_scheduler.hpp"
+#include "entities/agent/trajectory_log.hpp"
+#include "utils/log.hpp"
 #include <memory>
 
 namespace wbz {
@@ -17,7 +20,8 @@ public:
 
         _radar_radius(150.0f), _max_radar_radius(500.0f),
         _radar_expand_speed(20.0f) {
-    std::cout << "\nInitializing AI Character with stats:"
+    if (utils::Log::verbose())
+      std::cout << "\nInitializing AI Character with stats:"
               << "\nHealth: " << stats.max_health
               << "\nStamina: " << stats.max_stamina
               << "\nMovement Speed: " << stats.movement_speed
@@ -25,14 +29,62 @@ public:
   }
 
   void update(double delta_time) override;
-  void render(SDL_Renderer *renderer) const override;
+  void snapshot(RenderSnapshot &snapshot) const override;
+  void hash_state(utils::Hash &hash) const override;
 
   void start_new_episode();
 
   void set_opponent(Character *opponent);
 
-  void on_hit_landed();
-  void on_got_hit();
+  void on_hit_landed() override;
+  void on_got_hit() override;
+
+  // Trainer-driven mode: update() still computes the reward but executes
+  // the action given to set_action() instead of choosing and learning one.
+  // An attack action starts one attack per set_action() call.
+  void set_external_control(bool external) { _external_control = external; }
+  void set_action(ai::Action action) {
+    _external_action = action;
+    _attack_pending = true;
+  }
+  float last_reward() const { return _last_reward; }
+
+  float radar_radius() const { return _radar_radius; }
+  float max_radar_radius() const { return _max_radar_radius; }
+  bool is_opponent_in_radar() const;
+
+  void set_episode_logging(bool enabled) { _episode_logging = enabled; }
+
+  // Hands the character another agent, returning the one it had, so a
+  // policy can outlive the characters that play it.
+  std::unique_ptr<ai::QLearningAgent>
+  swap_agent(std::unique_ptr<ai::QLearningAgent> agent) {
+    ai_agent.swap(agent);
+    return agent;
+  }
+  ai::QLearningAgent &agent() { return *ai_agent; }
+  // A character that is not learning plays its agent's policy as is.
+  void set_learning(bool learning) { _learning = learning; }
+
+  // Decides once every scheduler->interval() ticks, within the
+  // scheduler's budget, and repeats the action in between. Without a
+  // scheduler it decides every tick.
+  void set_decision_scheduler(ai::DecisionScheduler *scheduler);
+
+  // Background planning between ticks; see QLearningAgent::plan.
+  void enable_planning() { ai_agent->enable_planning(); }
+  uint32_t plan(std::chrono::steady_clock::time_point deadline) {
+    return _external_control ? 0 : ai_agent->plan(deadline);
+  }
+
+  // Plays a Q-table checkpoint, such as one written by batch_train.
+  void load_q_table(const std::string &path) { ai_agent->load_table(path); }
+
+  // Every transition update() produces is appended to the writer, which
+  // must outlive the character.
+  void set_trajectory_writer(ai::TrajectoryWriter *writer) {
+    _trajectory = writer;
+  }
 
 protected:
   void handle_defeat() override;
@@ -52,15 +104,16 @@ private:
   ai::State _previous_state;
   ai::Action _previous_action;
   bool _has_previous_state = false;
+  bool _attack_pending = false;
 
   float _previous_health;
   float _previous_opponent_health;
-  float _episode_timer;
+  float _episode_timer = 0.0f;
   float _time_since_last_action;
   int _training_episode;
-  int _hits_landed;
-  float _average_distance;
-  int _hits_taken;
+  int _hits_landed = 0;
+  float _average_distance = 0.0f;
+  int _hits_taken = 0;
   bool _hit_landed;
   bool _got_hit;
 
@@ -68,11 +121,30 @@ private:
   float _max_radar_radius;
   float _radar_expand_speed;
 
-  void execute_action(ai::Action action);
+  bool _external_control = false;
+  ai::Action _external_action = ai::Action::IDLE;
+  float _last_reward = 0.0f;
+  bool _episode_logging = true;
+  ai::TrajectoryWriter *_trajectory = nullptr;
+  bool _trajectory_split = false;
 
-  bool is_opponent_in_radar() const;
+  bool _learning = true;
+  ai::DecisionScheduler *_scheduler = nullptr;
+  uint32_t _decision_interval = 1;
+  uint32_t _ticks_until_decision = 0;
+  float _decision_reward = 0.0f;
+
+  bool is_decision_tick();
+  void decide(bool in_radar);
+
+  // Closes the trajectory episode and drops the transition spanning the
+  // boundary, so the next one starts a new episode.
+  void end_trajectory_episode(bool terminal);
+
+  void execute_action(ai::Action action);
+  void start_attack(const char *attack);
 
-  void draw_radar(SDL_Renderer *renderer) const;
+  void snapshot_radar(RenderSnapshot &snapshot) const;
 };
 
 } // namespace entities
@@ -1,14 +1,20 @@
 #include "character.hpp"
 #include "math/vector2.hpp"
-#include "text/text_renderer.hpp"
 #include "utils/r.hpp"
-#include <SDL2/SDL_ttf.h>
 #include <algorithm>
 #include <iostream>
 
 namespace wbz {
 namespace entities {
 
+static const char *CHARACTER_ANIMATION_NAMES[] = {
+    "Idle", "Up", "Down", "Left", "Right", "Block", "Stunned", "Recovery", "Hit",
+};
+static_assert(sizeof(CHARACTER_ANIMATION_NAMES) /
+                      sizeof(CHARACTER_ANIMATION_NAMES[0]) ==
+                  static_cast<size_t>(CharacterAnimation::COUNT),
+              "Missing character animation name");
+
 Character::Character(const Sprite &sprite, const CombatStats &stats)
     : _sprite(sprite), _stats(stats), _current_combat_state(CombatState::IDLE),
       _staring_at(nullptr), _is_looking_right(true), _state_timer(0.0f),
@@ -25,6 +31,7 @@ Character::Character(const Sprite &sprite, const CombatStats &stats)
   _current_hit_box = HitBox();
   _current_hit_box.is_active = false;
 
+  _animation_ids.fill(INVALID_ANIMATION);
   register_basic_attacks();
 
   _rect.w = 64;
@@ -50,7 +57,48 @@ void Character::register_basic_attacks() {
              "kick_heavy", Vector2f(60, 35), Vector2f(45, 10));
 }
 
+void Character::set_animations(std::shared_ptr<const AnimationSet> animations) {
+  for (size_t i = 0; i < _animation_ids.size(); ++i) {
+    _animation_ids[i] =
+        animations ? animations->id(CHARACTER_ANIMATION_NAMES[i])
+                   : INVALID_ANIMATION;
+  }
+
+  for (auto &[name, attack] : _attacks) {
+    attack.animation_id = animations ? animations->id(attack.animation_name)
+                                     : INVALID_ANIMATION;
+  }
+
+  _animator.set_animations(std::move(animations));
+}
+
+void Character::play_animation(CharacterAnimation animation) {
+  _animator.play(_animation_ids[static_cast<size_t>(animation)], _clock);
+}
+
+void Character::update_presentation(double delta_time) {
+  for (size_t i = 0; i < _pending_text_count; ++i) {
+    const auto &event =
+        _pending_texts[(_pending_text_next + PENDING_TEXT_CAPACITY -
+                        _pending_text_count + i) %
+                       PENDING_TEXT_CAPACITY];
+    if (_clock - event.time < FLOATING_TEXT_LIFETIME) {
+      spawn_floating_text(event);
+    }
+  }
+  _pending_text_count = 0;
+  update_floating_texts(delta_time);
+
+  const SDL_Rect &current_frame = _animator.frame(_clock);
+  Vector2f pos = _mover.position();
+  _sprite.set_frame(current_frame);
+  _sprite.set_position(static_cast<int>(pos.x - current_frame.w / 2.0f),
+                       static_cast<int>(pos.y - current_frame.h / 2.0f));
+}
+
 void Character::update(double delta_time) {
+  _clock += delta_time;
+
   update_timers(delta_time);
   update_combat_state(delta_time);
   update_combos(delta_time);
@@ -97,15 +145,6 @@ void Character::update(double delta_time) {
 
   _mover.set_position(pos);
 
-  _sprite.set_frame(_animator.frame());
-  SDL_Rect current_frame = _animator.frame();
-  float adjusted_x = pos.x - current_frame.w / 2.0f;
-  float adjusted_y = pos.y - current_frame.h / 2.0f;
-  _sprite.set_position(static_cast<int>(adjusted_x),
-                       static_cast<int>(adjusted_y));
-
-  _animator.update(delta_time);
-
   if (_staring_at != nullptr) {
     _is_looking_right = (_staring_at->x - pos.x) < 0;
   }
@@ -164,16 +203,19 @@ void Character::update_combat_state(double delta_time) {
 }
 
 void Character::update_combos(double delta_time) {
-  const float COMBO_WINDOW = 1.0f;
+  const double COMBO_WINDOW = 1.0;
 
   while (!_recent_hit_times.empty() &&
-         _recent_hit_times.front() >= COMBO_WINDOW) {
+         _clock - _recent_hit_times.front() >= COMBO_WINDOW) {
     _recent_hit_times.pop();
   }
 
-  if (_recent_hit_times.empty()) {
-    _combo_counter = 0;
-  }
+  _combo_counter = static_cast<int>(_recent_hit_times.size());
+}
+
+void Character::register_hit() {
+  _recent_hit_times.push(_clock);
+  _combo_counter = static_cast<int>(_recent_hit_times.size());
 }
 
 bool Character::perform_attack(const std::string &attack_name) {
@@ -190,15 +232,18 @@ bool Character::perform_attack(const std::string &attack_name) {
   _state.stamina -= attack.stamina_cost;
 
   set_combat_state(CombatState::ATTACKING);
-  _state.attack_timer =
-      attack.startup_frames + attack.active_frames + attack.recovery_frames;
+  _current_attack = &attack;
+  ++_attacks_started;
+  _state.attack_timer = (attack.startup_frames + attack.active_frames +
+                         attack.recovery_frames) /
+                        Attack::FRAME_DATA_RATE;
 
   _current_hit_box.size = attack.hit_box_size;
   _current_hit_box.offset = attack.hit_box_offset;
   _current_hit_box.offset.x *= _is_looking_right ? 1 : -1;
   _current_hit_box.is_active = false;
 
-  _animator.play(attack.animation_name);
+  _animator.play(attack.animation_id, _clock);
   return true;
 }
 
@@ -278,16 +323,16 @@ void Character::set_combat_state(CombatState new_state) {
 
   switch (new_state) {
   case CombatState::IDLE:
-    _animator.play("Idle");
+    play_animation(CharacterAnimation::IDLE);
     break;
   case CombatState::BLOCKING:
-    _animator.play("Block");
+    play_animation(CharacterAnimation::BLOCK);
     break;
   case CombatState::STUNNED:
-    _animator.play("Stunned");
+    play_animation(CharacterAnimation::STUNNED);
     break;
   case CombatState::RECOVERY:
-    _animator.play("Recovery");
+    play_animation(CharacterAnimation::RECOVERY);
     break;
   default:
     break;
@@ -295,10 +340,16 @@ void Character::set_combat_state(CombatState new_state) {
 }
 
 bool Character::can_attack() const {
-  return _current_combat_state == CombatState::IDLE ||
-         _current_combat_state == CombatState::WALKING ||
-         (_current_combat_state == CombatState::ATTACKING &&
-          _attacks.at("idle").can_be_canceled);
+  if (_current_combat_state == CombatState::IDLE ||
+      _current_combat_state == CombatState::WALKING) {
+    return true;
+  }
+
+  // Cancelable attacks can chain into another once they are recovering.
+  return _current_combat_state == CombatState::ATTACKING && _current_attack &&
+         _current_attack->can_be_canceled &&
+         _state.attack_timer <=
+             _current_attack->recovery_frames / Attack::FRAME_DATA_RATE;
 }
 
 bool Character::can_block() const {
@@ -345,84 +396,66 @@ void Character::apply_movement_forces() {
   float final_speed = _stats.movement_speed * speed_multiplier;
 }
 
-void Character::render(SDL_Renderer *renderer) const {
-
-  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-  _sprite.render(renderer, !_is_looking_right);
+void Character::snapshot(RenderSnapshot &snapshot) const {
+  _sprite.snapshot(snapshot, !_is_looking_right);
 
-  render_debug_boxes(renderer);
+  snapshot_debug_boxes(snapshot);
 
-  render_health_bar(renderer);
-  render_stamina_bar(renderer);
-  render_state_info(renderer);
+  snapshot_health_bar(snapshot);
+  snapshot_stamina_bar(snapshot);
+  snapshot_state_info(snapshot);
 
-  render_floating_text(renderer);
+  snapshot_floating_text(snapshot);
 }
 
-void Character::render_debug_boxes(SDL_Renderer *renderer) const {
-
-  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 128);
+void Character::snapshot_debug_boxes(RenderSnapshot &snapshot) const {
   SDL_Rect bounds = {static_cast<int>(_mover.position().x - _rect.w / 2),
                      static_cast<int>(_mover.position().y - _rect.h / 2),
                      _rect.w, _rect.h};
-  SDL_RenderDrawRect(renderer, &bounds);
+  snapshot.debug.rect(DebugCategory::BOUNDS, bounds, {255, 255, 255, 128});
 
-  SDL_SetRenderDrawColor(renderer, 0, 255, 0, 128);
   Vector2f hurt_pos = _mover.position().add(_hurt_box.offset);
   SDL_Rect hurt_rect = {
       static_cast<int>(hurt_pos.x), static_cast<int>(hurt_pos.y),
       static_cast<int>(_hurt_box.size.x), static_cast<int>(_hurt_box.size.y)};
-  SDL_RenderDrawRect(renderer, &hurt_rect);
+  snapshot.debug.rect(DebugCategory::HURT_BOXES, hurt_rect, {0, 255, 0, 128});
 
   if (_current_combat_state == CombatState::ATTACKING &&
-      _current_hit_box.is_active) {
+      _current_hit_box.is_active && DebugDraw::enabled(DebugCategory::HIT_BOXES)) {
 
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 64);
     Vector2f hit_pos = _mover.position().add(_current_hit_box.offset);
     SDL_Rect hit_rect = {static_cast<int>(hit_pos.x),
                          static_cast<int>(hit_pos.y),
                          static_cast<int>(_current_hit_box.size.x),
                          static_cast<int>(_current_hit_box.size.y)};
-    SDL_RenderFillRect(renderer, &hit_rect);
+    snapshot.debug.fill_rect(DebugCategory::HIT_BOXES, hit_rect,
+                             {255, 0, 0, 64});
+    snapshot.debug.rect(DebugCategory::HIT_BOXES, hit_rect, {255, 0, 0, 255});
 
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &hit_rect);
-
-    SDL_SetRenderDrawColor(renderer, 255, 128, 0, 255);
     int center_x = hit_rect.x + hit_rect.w / 2;
     int center_y = hit_rect.y + hit_rect.h / 2;
-    SDL_RenderDrawLine(renderer, center_x, center_y,
-                       center_x + (_is_looking_right ? 20 : -20), center_y);
+    snapshot.debug.arrow(DebugCategory::HIT_BOXES, center_x, center_y,
+                         center_x + (_is_looking_right ? 20 : -20), center_y,
+                         {255, 128, 0, 255});
   }
 }
 
-void Character::render_state_info(SDL_Renderer *renderer) const {
-  const int TEXT_HEIGHT = 15;
+void Character::snapshot_state_info(RenderSnapshot &snapshot) const {
   Vector2f pos = _mover.position();
+  int x = static_cast<int>(pos.x - 30);
+  int y = static_cast<int>(pos.y - _rect.h);
 
-  std::string state_text = get_state_text();
-  render_text(renderer, state_text, pos.x - 30, pos.y - _rect.h - 60,
-              {255, 255, 255, 255});
-
-  std::string info_text = std::string("HP: ") + std::to_string(_state.health) +
-                          "/" + std::to_string(_state.max_health);
-  render_text(renderer, info_text, pos.x - 30, pos.y - _rect.h - 80,
-              {255, 255, 255, 255});
+  snapshot.add_text(x, y - 60, {255, 255, 255, 255}, 16, "%s",
+                    get_state_text());
+  snapshot.add_text(x, y - 80, {255, 255, 255, 255}, 16, "HP: %d/%d",
+                    _state.health, _state.max_health);
 
   Vector2f vel = _mover.velocity();
-  std::string vel_text = "vel: (" + std::to_string(static_cast<int>(vel.x)) +
-                         "," + std::to_string(static_cast<int>(vel.y)) + ")";
-  render_text(renderer, vel_text, pos.x - 30, pos.y - _rect.h - 100,
-              {200, 200, 200, 255});
-}
-
-void Character::render_text(SDL_Renderer *renderer, const std::string &text,
-                            float x, float y, SDL_Color color) const {
-  TextRenderer::instance().render_text(renderer, text, static_cast<int>(x),
-                                       static_cast<int>(y), color, 16);
+  snapshot.add_text(x, y - 100, {200, 200, 200, 255}, 16, "vel: (%d,%d)",
+                    static_cast<int>(vel.x), static_cast<int>(vel.y));
 }
 
-std::string Character::get_state_text() const {
+const char *Character::get_state_text() const {
   switch (_current_combat_state) {
   case CombatState::IDLE:
     return "IDLE";
@@ -447,7 +480,7 @@ std::string Character::get_state_text() const {
   }
 }
 
-void Character::render_health_bar(SDL_Renderer *renderer) const {
+void Character::snapshot_health_bar(RenderSnapshot &snapshot) const {
   const int BAR_WIDTH = 50;
   const int BAR_HEIGHT = 5;
   const int BAR_Y_OFFSET = 40;
@@ -455,17 +488,14 @@ void Character::render_health_bar(SDL_Renderer *renderer) const {
   SDL_Rect health_bar = {static_cast<int>(_mover.position().x - BAR_WIDTH / 2),
                          static_cast<int>(_mover.position().y - BAR_Y_OFFSET),
                          BAR_WIDTH, BAR_HEIGHT};
-
-  SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-  SDL_RenderFillRect(renderer, &health_bar);
+  snapshot.add_bar(health_bar, {255, 0, 0, 255});
 
   float health_ratio = static_cast<float>(_state.health) / _state.max_health;
   health_bar.w = static_cast<int>(BAR_WIDTH * health_ratio);
-  SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-  SDL_RenderFillRect(renderer, &health_bar);
+  snapshot.add_bar(health_bar, {0, 255, 0, 255});
 }
 
-void Character::render_stamina_bar(SDL_Renderer *renderer) const {
+void Character::snapshot_stamina_bar(RenderSnapshot &snapshot) const {
   const int BAR_WIDTH = 40;
   const int BAR_HEIGHT = 3;
   const int BAR_Y_OFFSET = 35;
@@ -473,85 +503,78 @@ void Character::render_stamina_bar(SDL_Renderer *renderer) const {
   SDL_Rect stamina_bar = {static_cast<int>(_mover.position().x - BAR_WIDTH / 2),
                           static_cast<int>(_mover.position().y - BAR_Y_OFFSET),
                           BAR_WIDTH, BAR_HEIGHT};
-
-  SDL_SetRenderDrawColor(renderer, 64, 64, 255, 255);
-  SDL_RenderFillRect(renderer, &stamina_bar);
+  snapshot.add_bar(stamina_bar, {64, 64, 255, 255});
 
   float stamina_ratio = static_cast<float>(_state.stamina) / _state.max_stamina;
   stamina_bar.w = static_cast<int>(BAR_WIDTH * stamina_ratio);
-  SDL_SetRenderDrawColor(renderer, 0, 128, 255, 255);
-  SDL_RenderFillRect(renderer, &stamina_bar);
+  snapshot.add_bar(stamina_bar, {0, 128, 255, 255});
+}
+
+void Character::hash_state(utils::Hash &hash) const {
+  hash.add(_mover.position().x);
+  hash.add(_mover.position().y);
+  hash.add(_mover.velocity().x);
+  hash.add(_mover.velocity().y);
+  hash.add(_state.health);
+  hash.add(_state.stamina);
+  hash.add(_state.hit_stun_timer);
+  hash.add(_state.attack_timer);
+  hash.add(static_cast<int>(_current_combat_state));
+  hash.add(_state_timer);
+  hash.add(_invulnerability_timer);
+  hash.add(_recovery_timer);
+  hash.add(_combo_counter);
+  hash.add(_is_looking_right);
 }
 
 void Character::stare_at(const Vector2f *target) { _staring_at = target; }
 
-void Character::add_floating_text(const std::string &text,
-                                  const Vector2f &position,
-                                  const SDL_Color &color) {
+void Character::add_floating_text(FloatingTextStyle style,
+                                  const Vector2f &position, int value) {
+  // Only record the event; formatting and motion are presentation work.
+  _pending_texts[_pending_text_next] = {style, value, position, _clock};
+  _pending_text_next = (_pending_text_next + 1) % PENDING_TEXT_CAPACITY;
+  _pending_text_count =
+      std::min(_pending_text_count + 1, PENDING_TEXT_CAPACITY);
+}
 
-  float random_angle = (std::rand() % 60 - 30) * 3.14f / 180.0f;
+void Character::spawn_floating_text(const CombatTextEvent &event) {
+  float random_angle = _presentation_random.range(-30, 29) * 3.14f / 180.0f;
   float speed = 200.0f;
 
   Vector2f velocity(std::cos(random_angle) * speed,
                     std::sin(random_angle) * speed - 300.0f);
 
-  int text_size = 16;
-  if (text.find("CRITICAL") != std::string::npos) {
-    text_size = 24;
-  } else if (text.find("BLOCK") != std::string::npos) {
-    text_size = 20;
-  }
-
-  FloatingText ft(text, position, velocity, 1.5f, color);
-  ft.size = text_size;
-  _floating_texts.emplace_back(std::move(ft));
-
-  std::cout << "Combat Event: " << text << " at position (" << position.x
-            << ", " << position.y << ")\n";
+  _floating_texts.spawn(event.style, event.value, event.position, velocity,
+                        FLOATING_TEXT_LIFETIME);
 }
 
 void Character::update_floating_texts(double delta_time) {
-  for (auto &text : _floating_texts) {
-    text.position = text.position.add(text.velocity.mul(delta_time));
-    text.lifetime -= delta_time;
-
-    text.velocity = text.velocity.mul(0.95f);
-  }
-
-  _floating_texts.erase(std::remove_if(_floating_texts.begin(),
-                                       _floating_texts.end(),
-                                       [](const FloatingText &text) {
-                                         return text.lifetime <= 0;
-                                       }),
-                        _floating_texts.end());
+  _floating_texts.update(static_cast<float>(delta_time));
 }
 
-void Character::render_floating_text(SDL_Renderer *renderer) const {
-  for (const auto &text : _floating_texts) {
+void Character::snapshot_floating_text(RenderSnapshot &snapshot) const {
+  for (size_t i = 0; i < _floating_texts.size(); ++i) {
+    const auto &style = floating_text_style(_floating_texts.style(i));
 
-    SDL_Color color = text.color;
-    float fade = std::min(1.0f, text.lifetime);
+    SDL_Color color = style.color;
+    float fade = std::min(1.0f, _floating_texts.lifetime(i));
     fade = fade * fade;
     color.a = static_cast<Uint8>(255 * fade);
 
-    float scaled_x = text.position.x;
-    float scaled_y = text.position.y;
+    int x = static_cast<int>(_floating_texts.x(i));
+    int y = static_cast<int>(_floating_texts.y(i));
 
     SDL_Color shadow_color = {0, 0, 0, color.a};
-    TextRenderer::instance().render_text(
-        renderer, text.text, static_cast<int>(scaled_x + 2),
-        static_cast<int>(scaled_y + 2), shadow_color,
-        static_cast<int>(text.size));
-
-    TextRenderer::instance().render_text(
-        renderer, text.text, static_cast<int>(scaled_x),
-        static_cast<int>(scaled_y), color, static_cast<int>(text.size));
+    snapshot.add_text(x + 2, y + 2, shadow_color, style.size, "%s",
+                      _floating_texts.text(i));
+    snapshot.add_text(x, y, color, style.size, "%s", _floating_texts.text(i));
   }
 }
 
 void Character::apply_hit(const Attack &attack, const Vector2f &attacker_pos) {
   if (_invulnerability_timer > 0.0f) {
-    add_floating_text("BLOCK!", _mover.position(), {255, 255, 0, 255});
+    add_floating_text(FloatingTextStyle::BLOCK, _mover.position());
     return;
   }
 
@@ -560,7 +583,7 @@ void Character::apply_hit(const Attack &attack, const Vector2f &attacker_pos) {
   // Keep the knockback and animation code
   Vector2f knockback_dir = (_mover.position().sub(attacker_pos)).normalized();
   apply_knockback(knockback_dir, attack.knockback_force);
-  _animator.play("Hit");
+  play_animation(CharacterAnimation::HIT);
 }
 
 void Character::reset() {
@@ -569,6 +592,9 @@ void Character::reset() {
   _state.is_invulnerable = false;
   _state.hit_stun_timer = 0.0f;
   _state.attack_timer = 0.0f;
+  _current_attack = nullptr;
+  _recent_hit_times = {};
+  _combo_counter = 0;
   set_combat_state(CombatState::IDLE);
   _mover.set_velocity(Vector2f::zero());
 }
@@ -583,16 +609,13 @@ void Character::apply_damage(int raw_damage) {
 
   // Add visual and audio feedback
   Vector2f damage_pos = _mover.position().add(Vector2f(0, -30));
-  SDL_Color color = {255, 0, 0, 255};
 
   if (defense_multiplier < 1.0f) {
-    add_floating_text("BLOCKED! " + std::to_string(final_damage), damage_pos,
-                      {255, 255, 0, 255});
+    add_floating_text(FloatingTextStyle::BLOCKED, damage_pos, final_damage);
   } else if (final_damage >= 20) {
-    add_floating_text("CRITICAL! " + std::to_string(final_damage), damage_pos,
-                      {255, 165, 0, 255});
+    add_floating_text(FloatingTextStyle::CRITICAL, damage_pos, final_damage);
   } else {
-    add_floating_text(std::to_string(final_damage), damage_pos, color);
+    add_floating_text(FloatingTextStyle::DAMAGE, damage_pos, final_damage);
   }
 
   // Trigger hit reactions
@@ -605,7 +628,32 @@ void Character::apply_damage(int raw_damage) {
 }
 void Character::handle_defeat() {
   set_combat_state(CombatState::STUNNED);
-  add_floating_text("DEFEATED!", _mover.position(), {255, 0, 0, 255});
+  add_floating_text(FloatingTextStyle::DEFEATED, _mover.position());
+}
+
+namespace {
+// Half a character's width, added to an attack's range.
+constexpr float BODY_REACH = 32.0f;
+} // namespace
+
+bool resolve_attack(Character &attacker, Character &defender) {
+  const Attack *attack = attacker.current_attack();
+  if (!attack || !defender.is_vulnerable()) {
+    return false;
+  }
+
+  float distance =
+      attacker.mover().position().sub(defender.mover().position()).mag();
+  if (distance > attack->range + BODY_REACH) {
+    return false;
+  }
+
+  defender.apply_hit(*attack, attacker.mover().position());
+  attacker.register_hit();
+  attacker.on_hit_landed();
+  defender.on_got_hit();
+  return true;
 }
+
 } // namespace entities
 } // namespace wbz
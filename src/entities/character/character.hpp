@@ -1,7 +1,10 @@
 #pragma once
-#include "SDL_render.h"
+#include "SDL_rect.h"
+#include "entities/character/floating_text.hpp"
 #include "math/vector2.hpp"
 #include "sprite/animator/animator.hpp"
+#include "utils/random.hpp"
+#include <array>
 #include <entities/entity.hpp>
 #include <mover/mover.hpp>
 #include <queue>
@@ -23,6 +26,19 @@ enum class CombatState {
   RECOVERY
 };
 
+enum class CharacterAnimation {
+  IDLE,
+  UP,
+  DOWN,
+  LEFT,
+  RIGHT,
+  BLOCK,
+  STUNNED,
+  RECOVERY,
+  HIT,
+  COUNT
+};
+
 struct CombatStats {
   int max_health;
   int max_stamina;
@@ -41,6 +57,9 @@ struct CombatStats {
 };
 
 struct Attack {
+  // Frame data is authored at 60 frames per second.
+  static constexpr float FRAME_DATA_RATE = 60.0f;
+
   std::string name;
   int damage;
   float range;
@@ -51,6 +70,7 @@ struct Attack {
   int stamina_cost;
   bool can_be_canceled;
   std::string animation_name;
+  AnimationId animation_id = INVALID_ANIMATION;
   Vector2f hit_box_size;
   Vector2f hit_box_offset;
 
@@ -106,20 +126,6 @@ struct CharacterState {
   }
 };
 
-struct FloatingText {
-  std::string text;
-  Vector2f position;
-  Vector2f velocity;
-  float lifetime;
-  SDL_Color color;
-  int size;
-
-  FloatingText(const std::string &t, const Vector2f &pos, const Vector2f &vel,
-               float life, const SDL_Color &col, int size = 16)
-      : text(t), position(pos), velocity(vel), lifetime(life), color(col),
-        size(size) {}
-};
-
 class Character : public Entity {
 public:
   explicit Character(const Sprite &sprite,
@@ -132,6 +138,8 @@ public:
   const CharacterState &state() const { return _state; }
 
   Animator &animator() { return _animator; }
+  void set_animations(std::shared_ptr<const AnimationSet> animations);
+  void play_animation(CharacterAnimation animation);
 
   void reset();
   void apply_damage(int raw_damage);
@@ -140,6 +148,10 @@ public:
   CombatState get_combat_state() const { return _current_combat_state; }
 
   bool perform_attack(const std::string &attack_name);
+  // The attack being performed, or the last one.
+  const Attack *current_attack() const { return _current_attack; }
+  // Attacks started so far, so callers can tell a new one began.
+  uint32_t attacks_started() const { return _attacks_started; }
   bool is_hit_connecting(const Character &other, const Attack &attack) const;
   void apply_hit(const Attack &attack, const Vector2f &attacker_pos);
 
@@ -155,9 +167,16 @@ public:
   float get_attack_multiplier() const;
   float get_defense_multiplier() const;
   int get_combo_count() const { return _combo_counter; }
+  // Counts a landed hit towards the combo.
+  void register_hit();
+  // Called by resolve_attack on both sides of a landed hit.
+  virtual void on_hit_landed() {}
+  virtual void on_got_hit() {}
 
   void update(double delta_time) override;
-  void render(SDL_Renderer *renderer) const override;
+  void update_presentation(double delta_time) override;
+  void hash_state(utils::Hash &hash) const override;
+  void snapshot(RenderSnapshot &snapshot) const override;
 
   void stare_at(const Vector2f *target);
   bool is_facing_right() const { return _is_looking_right; }
@@ -172,6 +191,8 @@ private:
   Mover _mover;
   Sprite _sprite;
   Animator _animator;
+  std::array<AnimationId, static_cast<size_t>(CharacterAnimation::COUNT)>
+      _animation_ids;
 
   CombatStats _stats;
   int _current_health;
@@ -183,7 +204,10 @@ private:
   float _invulnerability_timer;
   float _recovery_timer;
   int _combo_counter;
-  std::queue<float> _recent_hit_times;
+  // Simulation clock of each hit landed within the combo window.
+  std::queue<double> _recent_hit_times;
+  const Attack *_current_attack = nullptr;
+  uint32_t _attacks_started = 0;
 
   const Vector2f *_staring_at;
   bool _is_looking_right;
@@ -192,7 +216,26 @@ private:
   HitBox _hurt_box;
   HitBox _current_hit_box;
 
-  mutable std::vector<FloatingText> _floating_texts;
+  // Simulation time, drives animation playback.
+  double _clock = 0.0;
+
+  // Combat texts raised by the simulation, spawned into the pool only when
+  // a frame is presented.
+  struct CombatTextEvent {
+    FloatingTextStyle style;
+    int value;
+    Vector2f position;
+    double time;
+  };
+  static constexpr size_t PENDING_TEXT_CAPACITY = 8;
+  static constexpr float FLOATING_TEXT_LIFETIME = 1.5f;
+  std::array<CombatTextEvent, PENDING_TEXT_CAPACITY> _pending_texts;
+  size_t _pending_text_next = 0;
+  size_t _pending_text_count = 0;
+
+  FloatingTextPool _floating_texts;
+  // Kept apart from any simulation stream: texts spawn per presented frame.
+  utils::Random _presentation_random = utils::Random::stream();
 
   void update_combat_state(double delta_time);
   void update_timers(double delta_time);
@@ -200,17 +243,21 @@ private:
   void update_floating_texts(double delta_time);
   void apply_movement_forces();
   void register_basic_attacks();
-  void render_debug_boxes(SDL_Renderer *renderer) const;
-  void render_health_bar(SDL_Renderer *renderer) const;
-  void render_stamina_bar(SDL_Renderer *renderer) const;
-  void render_state_info(SDL_Renderer *renderer) const;
-  void render_floating_text(SDL_Renderer *renderer) const;
-  void render_text(SDL_Renderer *renderer, const std::string &text, float x,
-                   float y, SDL_Color color) const;
-  std::string get_state_text() const;
-  void add_floating_text(const std::string &text, const Vector2f &position,
-                         const SDL_Color &color);
+  void snapshot_debug_boxes(RenderSnapshot &snapshot) const;
+  void snapshot_health_bar(RenderSnapshot &snapshot) const;
+  void snapshot_stamina_bar(RenderSnapshot &snapshot) const;
+  void snapshot_state_info(RenderSnapshot &snapshot) const;
+  void snapshot_floating_text(RenderSnapshot &snapshot) const;
+  const char *get_state_text() const;
+  void add_floating_text(FloatingTextStyle style, const Vector2f &position,
+                         int value = 0);
+  void spawn_floating_text(const CombatTextEvent &event);
 };
 
+// Lands the attacker's current attack if the defender is vulnerable and
+// within the attack's range of it, and tells both characters about the hit.
+// Returns whether it landed.
+bool resolve_attack(Character &attacker, Character &defender);
+
 } // namespace entities
 } // namespace wbz
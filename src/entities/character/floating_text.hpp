@@ -0,0 +1,127 @@
+#pragma once
+
+#include "SDL_pixels.h"
+#include "math/vector2.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace wbz {
+namespace entities {
+
+enum class FloatingTextStyle : uint8_t {
+  DAMAGE,
+  CRITICAL,
+  BLOCKED,
+  BLOCK,
+  DEFEATED,
+  COUNT
+};
+
+struct FloatingTextStyleInfo {
+  const char *format;
+  SDL_Color color;
+  int size;
+};
+
+inline const FloatingTextStyleInfo &
+floating_text_style(FloatingTextStyle style) {
+  static const FloatingTextStyleInfo STYLES[] = {
+      {"%d", {255, 0, 0, 255}, 16},
+      {"CRITICAL! %d", {255, 165, 0, 255}, 24},
+      {"BLOCKED! %d", {255, 255, 0, 255}, 20},
+      {"BLOCK!", {255, 255, 0, 255}, 20},
+      {"DEFEATED!", {255, 0, 0, 255}, 16},
+  };
+  static_assert(sizeof(STYLES) / sizeof(STYLES[0]) ==
+                    static_cast<size_t>(FloatingTextStyle::COUNT),
+                "Missing floating text style");
+  return STYLES[static_cast<size_t>(style)];
+}
+
+// Fixed-capacity pool of combat texts stored as structure-of-arrays so the
+// per-frame integration is a straight, vectorizable loop. Strings are
+// formatted once into inline buffers; nothing here touches the heap. When the
+// pool is full the text closest to expiring is recycled.
+class FloatingTextPool {
+public:
+  static constexpr size_t CAPACITY = 32;
+  static constexpr size_t TEXT_LENGTH = 16;
+
+  void spawn(FloatingTextStyle style, int value, const Vector2f &position,
+             const Vector2f &velocity, float lifetime) {
+    size_t index = _count < CAPACITY ? _count++ : soonest_to_expire();
+
+    _x[index] = position.x;
+    _y[index] = position.y;
+    _vx[index] = velocity.x;
+    _vy[index] = velocity.y;
+    _lifetime[index] = lifetime;
+    _style[index] = style;
+    std::snprintf(_text[index], TEXT_LENGTH, floating_text_style(style).format,
+                  value);
+  }
+
+  void update(float delta_time, float damping = 0.95f) {
+    const size_t count = _count;
+    for (size_t i = 0; i < count; ++i) {
+      _x[i] += _vx[i] * delta_time;
+      _y[i] += _vy[i] * delta_time;
+      _vx[i] *= damping;
+      _vy[i] *= damping;
+      _lifetime[i] -= delta_time;
+    }
+
+    // Swap-remove expired entries; order is irrelevant for drawing.
+    for (size_t i = 0; i < _count;) {
+      if (_lifetime[i] > 0.0f) {
+        ++i;
+        continue;
+      }
+      move(--_count, i);
+    }
+  }
+
+  void clear() { _count = 0; }
+
+  size_t size() const { return _count; }
+  float x(size_t i) const { return _x[i]; }
+  float y(size_t i) const { return _y[i]; }
+  float lifetime(size_t i) const { return _lifetime[i]; }
+  FloatingTextStyle style(size_t i) const { return _style[i]; }
+  const char *text(size_t i) const { return _text[i]; }
+
+private:
+  alignas(16) float _x[CAPACITY];
+  alignas(16) float _y[CAPACITY];
+  alignas(16) float _vx[CAPACITY];
+  alignas(16) float _vy[CAPACITY];
+  alignas(16) float _lifetime[CAPACITY];
+  FloatingTextStyle _style[CAPACITY];
+  char _text[CAPACITY][TEXT_LENGTH];
+  size_t _count = 0;
+
+  size_t soonest_to_expire() const {
+    size_t soonest = 0;
+    for (size_t i = 1; i < _count; ++i) {
+      if (_lifetime[i] < _lifetime[soonest]) {
+        soonest = i;
+      }
+    }
+    return soonest;
+  }
+
+  void move(size_t from, size_t to) {
+    _x[to] = _x[from];
+    _y[to] = _y[from];
+    _vx[to] = _vx[from];
+    _vy[to] = _vy[from];
+    _lifetime[to] = _lifetime[from];
+    _style[to] = _style[from];
+    std::memcpy(_text[to], _text[from], TEXT_LENGTH);
+  }
+};
+
+} // namespace entities
+} // namespace wbz
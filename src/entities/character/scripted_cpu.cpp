@@ -0,0 +1,42 @@
+#include "scripted_cpu.hpp"
+#include <cmath>
+
+namespace wbz {
+namespace entities {
+
+namespace {
+const char *const ATTACKS[] = {"light_punch", "heavy_punch", "light_kick",
+                               "heavy_kick"};
+
+constexpr float APPROACH_DISTANCE = 200.0f;
+constexpr float RETREAT_DISTANCE = 100.0f;
+constexpr float MIN_ATTACK_DISTANCE = 20.0f;
+constexpr float MAX_ATTACK_DISTANCE = 150.0f;
+// Chance in percent of attacking on a tick in range.
+constexpr int ATTACK_CHANCE = 5;
+} // namespace
+
+void update_scripted_cpu(Character &cpu, const Character &target,
+                         utils::Random &random) {
+  Vector2f to_target = target.mover().position().sub(cpu.mover().position());
+  float distance = to_target.mag();
+  if (std::isnan(distance) || distance < 0.0001f || cpu.is_stunned() ||
+      cpu.is_in_recovery()) {
+    return;
+  }
+
+  Vector2f direction = to_target.normalized();
+  if (distance > APPROACH_DISTANCE) {
+    cpu.mover().add_force(direction.mul(3000.0f));
+  } else if (distance < RETREAT_DISTANCE) {
+    cpu.mover().add_force(direction.mul(-2000.0f));
+  }
+
+  if (distance > MIN_ATTACK_DISTANCE && distance < MAX_ATTACK_DISTANCE &&
+      cpu.can_attack() && random.range(0, 99) < ATTACK_CHANCE) {
+    cpu.perform_attack(ATTACKS[random.range(0, 3)]);
+  }
+}
+
+} // namespace entities
+} // namespace wbz
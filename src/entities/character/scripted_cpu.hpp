@@ -0,0 +1,14 @@
+#pragma once
+#include "character.hpp"
+#include "utils/random.hpp"
+
+namespace wbz {
+namespace entities {
+
+// The scripted CPU opponent: keeps to mid range of its target and throws
+// the occasional random attack. Call once per tick before updating cpu.
+void update_scripted_cpu(Character &cpu, const Character &target,
+                         utils::Random &random);
+
+} // namespace entities
+} // namespace wbz
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <SDL_render.h>
+#include <SDL_rect.h>
+#include <render/render_snapshot.hpp>
+#include <utils/hash.hpp>
 
 namespace wbz {
 namespace entities {
@@ -12,7 +14,12 @@ public:
   void set_height(int height) { _rect.h = height; }
 
   virtual void update(double delta_time) = 0;
-  virtual void render(SDL_Renderer *renderer) const = 0;
+  // Only called when a frame is about to be drawn.
+  virtual void update_presentation(double delta_time) {}
+  // Copies what is needed to draw the entity; runs on the simulation thread.
+  virtual void snapshot(RenderSnapshot &snapshot) const = 0;
+  // Folds the simulation state into a per-tick checksum.
+  virtual void hash_state(utils::Hash &hash) const {}
 
   const SDL_Rect &rect() const { return _rect; }
 
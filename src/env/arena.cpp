@@ -0,0 +1,180 @@
+#include "arena.hpp"
+#include "entities/character/scripted_cpu.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace wbz {
+namespace env {
+
+namespace {
+const Vector2f LEARNER_START(600.0f, 400.0f);
+const Vector2f OPPONENT_START(200.0f, 400.0f);
+
+const entities::CombatStats LEARNER_STATS(100, 100, 450.0f, 750.0f, 1.2f, 12,
+                                          0.9f);
+const entities::CombatStats OPPONENT_STATS(120, 100, 500.0f, 800.0f, 1.0f, 10,
+                                           1.1f);
+} // namespace
+
+Arena::Arena(const ArenaConfig &config)
+    : _config(config), _random(utils::Random::stream()) {
+  Sprite learner_sprite("goku_ssjb.png", {64, 2271, 64, 64}, {0, 0, 64, 64});
+  Sprite opponent_sprite("janemba.png", {64, 1271, 64, 64}, {0, 0, 64, 64});
+
+  _learner =
+      std::make_unique<entities::AICharacter>(learner_sprite, LEARNER_STATS);
+  _opponent =
+      std::make_unique<entities::Character>(opponent_sprite, OPPONENT_STATS);
+
+  _learner->swap_agent(std::make_unique<ai::QLearningAgent>(config.agent));
+  if (config.agent_control) {
+    _decisions = std::make_unique<ai::DecisionScheduler>(config.frame_skip);
+    _learner->set_decision_scheduler(_decisions.get());
+  } else {
+    _learner->set_external_control(true);
+  }
+  _learner->set_episode_logging(false);
+  _learner->set_opponent(_opponent.get());
+  _learner->stare_at(&_opponent->mover().position());
+  _opponent->stare_at(&_learner->mover().position());
+
+  reset();
+}
+
+void Arena::reset() {
+  _learner->reset();
+  _opponent->reset();
+  _learner->mover().set_position(LEARNER_START.add(start_offset()));
+  _opponent->mover().set_position(OPPONENT_START.add(start_offset()));
+  _learner->set_opponent(_opponent.get());
+  if (_opponent_ai) {
+    _opponent_ai->set_opponent(_learner.get());
+  }
+  _learner->set_action(ai::Action::IDLE);
+  _episode_ticks = 0;
+}
+
+void Arena::set_opponent_agent(std::unique_ptr<ai::QLearningAgent> agent) {
+  // A mirror match: same character and stats as the learner.
+  Sprite sprite("goku_ssjb.png", {64, 2271, 64, 64}, {0, 0, 64, 64});
+  auto opponent =
+      std::make_unique<entities::AICharacter>(sprite, LEARNER_STATS);
+  opponent->swap_agent(std::move(agent));
+  opponent->set_learning(false);
+  opponent->set_episode_logging(false);
+  if (!_decisions) {
+    _decisions = std::make_unique<ai::DecisionScheduler>(_config.frame_skip);
+  }
+  opponent->set_decision_scheduler(_decisions.get());
+
+  _opponent_ai = opponent.get();
+  _opponent = std::move(opponent);
+  _learner->stare_at(&_opponent->mover().position());
+  _opponent->stare_at(&_learner->mover().position());
+  reset();
+}
+
+void Arena::reseed(uint64_t seed) {
+  _random.seed(seed, 0);
+  _learner->agent().seed(seed, 1);
+  if (_opponent_ai) {
+    _opponent_ai->agent().seed(seed, 2);
+  }
+}
+
+bool Arena::step(ai::Action action, float &reward) {
+  if (!_config.agent_control) {
+    _learner->set_action(action);
+  }
+
+  reward = 0.0f;
+  for (uint32_t i = 0; i < std::max(1u, _config.frame_skip); ++i) {
+    tick();
+    reward += _learner->last_reward();
+
+    if (!_learner->state().is_alive() || !_opponent->state().is_alive() ||
+        (_config.max_episode_ticks &&
+         _episode_ticks >= _config.max_episode_ticks)) {
+      ++_episodes;
+      if (outcome() > 0) {
+        ++_wins;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void Arena::tick() {
+  const uint32_t learner_attacks = _learner->attacks_started();
+  const uint32_t opponent_attacks = _opponent->attacks_started();
+
+  if (_decisions) {
+    _decisions->begin_tick();
+  }
+  if (!_opponent_ai) {
+    entities::update_scripted_cpu(*_opponent, *_learner, _random);
+  }
+  _learner->update(_config.tick_seconds);
+  _opponent->update(_config.tick_seconds);
+
+  if (_learner->attacks_started() != learner_attacks) {
+    entities::resolve_attack(*_learner, *_opponent);
+  }
+  if (_opponent->attacks_started() != opponent_attacks) {
+    entities::resolve_attack(*_opponent, *_learner);
+  }
+
+  ++_episode_ticks;
+  ++_total_ticks;
+}
+
+Vector2f Arena::start_offset() {
+  if (_config.start_spread <= 0.0f) {
+    return Vector2f::zero();
+  }
+  const float x = (_random.uniform() * 2.0f - 1.0f) * _config.start_spread;
+  const float y = (_random.uniform() * 2.0f - 1.0f) * _config.start_spread;
+  return Vector2f(x, y);
+}
+
+int Arena::outcome() const {
+  const auto &learner = _learner->state();
+  const auto &opponent = _opponent->state();
+  if (learner.is_alive() != opponent.is_alive()) {
+    return learner.is_alive() ? 1 : -1;
+  }
+  const float learner_health =
+      static_cast<float>(learner.health) / learner.max_health;
+  const float opponent_health =
+      static_cast<float>(opponent.health) / opponent.max_health;
+  return learner_health > opponent_health   ? 1
+         : learner_health < opponent_health ? -1
+                                            : 0;
+}
+
+void Arena::observe(float *observation) const {
+  const Vector2f &position = _learner->mover().position();
+  const Vector2f offset = _opponent->mover().position().sub(position);
+  const auto &learner = _learner->state();
+  const auto &opponent = _opponent->state();
+
+  observation[0] = position.x / 800.0f;
+  observation[1] = position.y / 600.0f;
+  observation[2] = offset.x / 800.0f;
+  observation[3] = offset.y / 600.0f;
+  observation[4] = offset.mag() / 1000.0f;
+  observation[5] = static_cast<float>(learner.health) / learner.max_health;
+  observation[6] = static_cast<float>(learner.stamina) / learner.max_stamina;
+  observation[7] = static_cast<float>(opponent.health) / opponent.max_health;
+  observation[8] = _opponent->get_combat_state() ==
+                           entities::CombatState::ATTACKING
+                       ? 1.0f
+                       : 0.0f;
+  observation[9] = _learner->is_opponent_in_radar() ? 1.0f : 0.0f;
+  observation[10] = _learner->can_attack() ? 1.0f : 0.0f;
+  observation[11] = _learner->radar_radius() / _learner->max_radar_radius();
+}
+
+} // namespace env
+} // namespace wbz
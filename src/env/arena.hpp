@@ -0,0 +1,90 @@
+#pragma once
+
+#include "entities/character/ai_character.hpp"
+#include "utils/random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace wbz {
+namespace env {
+
+struct ArenaConfig {
+  // Simulation ticks per step, all running the same action.
+  uint32_t frame_skip = 4;
+  // Episodes are cut off after this many ticks, 0 for no limit.
+  uint32_t max_episode_ticks = 120 * 60;
+  double tick_seconds = 1.0 / 120.0;
+  // Each reset moves both fighters' start positions by up to this many
+  // pixels on each axis, drawn from the arena's seeded random stream.
+  float start_spread = 0.0f;
+  // The learner's own Q-learning agent picks its actions, once per step,
+  // and learns from them; step() then ignores its action argument.
+  bool agent_control = false;
+  // Learning and reward constants of the learner's agent.
+  ai::AgentParams agent;
+};
+
+// One fight outside of the Application: an externally controlled
+// AICharacter against a scripted opponent, stepped at a fixed tick with no
+// rendering or SDL. Hits land when an attack starts within its range of the
+// defender (see entities::resolve_attack).
+class Arena {
+public:
+  static constexpr size_t OBSERVATION_SIZE = 12;
+
+  explicit Arena(const ArenaConfig &config);
+
+  void reset();
+
+  // Runs the action for frame_skip ticks; an attack starts once, on the
+  // first tick the learner can attack. Returns whether the episode ended;
+  // the reward is the built-in agent's reward summed over the ticks.
+  bool step(ai::Action action, float &reward);
+
+  // Replaces the scripted opponent with an AI character playing the
+  // agent's policy without learning, deciding at the learner's rate.
+  void set_opponent_agent(std::unique_ptr<ai::QLearningAgent> agent);
+
+  // Reseeds the opponent and the learner's agent, so an arena built on any
+  // thread replays the same fights for a seed.
+  void reseed(uint64_t seed);
+
+  // Writes OBSERVATION_SIZE floats, all roughly in [-1, 1].
+  void observe(float *observation) const;
+
+  uint64_t episodes() const { return _episodes; }
+  uint64_t ticks() const { return _total_ticks; }
+  // Episodes ending with the opponent knocked out, or with the learner
+  // ahead on health at the tick limit.
+  uint64_t wins() const { return _wins; }
+
+  // 1 when the opponent is knocked out or the learner has more health
+  // left, -1 the other way around, 0 when level.
+  int outcome() const;
+  uint32_t episode_ticks() const { return _episode_ticks; }
+
+  entities::AICharacter &learner() { return *_learner; }
+  const entities::AICharacter &learner() const { return *_learner; }
+  const entities::Character &opponent() const { return *_opponent; }
+
+private:
+  ArenaConfig _config;
+  std::unique_ptr<entities::AICharacter> _learner;
+  std::unique_ptr<entities::Character> _opponent;
+  // Set when the opponent is an AI character instead of the scripted bot.
+  entities::AICharacter *_opponent_ai = nullptr;
+  utils::Random _random;
+  std::unique_ptr<ai::DecisionScheduler> _decisions;
+
+  uint32_t _episode_ticks = 0;
+  uint64_t _episodes = 0;
+  uint64_t _wins = 0;
+  uint64_t _total_ticks = 0;
+
+  void tick();
+  Vector2f start_offset();
+};
+
+} // namespace env
+} // namespace wbz
@@ -0,0 +1,100 @@
+#include "env_server.hpp"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace wbz {
+namespace env {
+
+EnvServer::EnvServer(const std::string &name, size_t env_count, size_t arenas,
+                     const ArenaConfig &config, uint64_t seed) {
+  _sessions.resize(env_count);
+  for (size_t i = 0; i < env_count; ++i) {
+    Session &session = _sessions[i];
+    session.env = std::make_unique<VectorEnv>(arenas, config, 1, seed + i);
+    session.channel = ShmChannel::create(ShmChannel::segment_name(name, i),
+                                         static_cast<uint32_t>(arenas),
+                                         Arena::OBSERVATION_SIZE);
+  }
+}
+
+void EnvServer::run() {
+  std::vector<std::thread> threads;
+  threads.reserve(_sessions.size());
+  for (auto &session : _sessions) {
+    threads.emplace_back([this, &session] { serve(session); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < _sessions.size(); ++i) {
+    std::cout << "Environment " << i << " served "
+              << _sessions[i].requests << " requests\n";
+    _sessions[i].channel.close();
+  }
+}
+
+void EnvServer::stop() {
+  _stopping = true;
+  for (auto &session : _sessions) {
+    session.channel.mark_closed();
+  }
+}
+
+void EnvServer::serve(Session &session) {
+  ShmChannel &channel = session.channel;
+  const size_t arenas = session.env->size();
+
+  while (!_stopping) {
+    ShmChannel::Request request;
+    try {
+      request = channel.wait_request();
+    } catch (const std::exception &) {
+      // Closed by stop().
+      return;
+    }
+
+    ShmChannel::Response response = channel.begin_response();
+    const uint32_t command = *request.command;
+    *response.status = WBZ_SHM_OK;
+
+    try {
+      switch (command) {
+      case WBZ_SHM_RESET:
+        session.env->reset(response.observations);
+        std::memset(response.rewards, 0, arenas * sizeof(float));
+        std::memset(response.dones, 0, arenas);
+        break;
+      case WBZ_SHM_STEP:
+        session.env->step(request.actions, response.observations,
+                          response.rewards, response.dones);
+        break;
+      case WBZ_SHM_CLOSE:
+        break;
+      default:
+        *response.status = WBZ_SHM_ERROR;
+        break;
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "Environment request failed: " << e.what() << "\n";
+      *response.status = WBZ_SHM_ERROR;
+    }
+
+    ++session.requests;
+    channel.release_request();
+    channel.end_response();
+
+    if (command == WBZ_SHM_CLOSE) {
+      return;
+    }
+  }
+}
+
+} // namespace env
+} // namespace wbz
+
+#endif
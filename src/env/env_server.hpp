@@ -0,0 +1,43 @@
+#pragma once
+
+#include "env/shm_channel.hpp"
+#include "env/vector_env.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wbz {
+namespace env {
+
+// Serves VectorEnvs to out-of-process clients over ShmChannels, one
+// segment and one thread per environment. Each environment steps in
+// lockstep with its client, writing results straight into the response
+// slot. Linux only.
+class EnvServer {
+public:
+  EnvServer(const std::string &name, size_t env_count, size_t arenas,
+            const ArenaConfig &config, uint64_t seed);
+
+  // Returns once every client has closed its environment, or after stop().
+  void run();
+  // Safe to call from any thread.
+  void stop();
+
+  size_t size() const { return _sessions.size(); }
+
+private:
+  struct Session {
+    std::unique_ptr<VectorEnv> env;
+    ShmChannel channel;
+    uint64_t requests = 0;
+  };
+
+  std::vector<Session> _sessions;
+  std::atomic<bool> _stopping{false};
+
+  void serve(Session &session);
+};
+
+} // namespace env
+} // namespace wbz
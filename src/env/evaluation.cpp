@@ -0,0 +1,153 @@
+#include "evaluation.hpp"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace wbz {
+namespace env {
+
+namespace {
+std::unique_ptr<ai::QLearningAgent>
+frozen_copy(const ai::QLearningAgent &agent) {
+  auto copy = std::make_unique<ai::QLearningAgent>();
+  copy->copy_table(agent);
+  copy->set_greedy(true);
+  return copy;
+}
+
+// Sums of a per-match quantity, for its mean and standard error.
+struct Moments {
+  double sum = 0.0;
+  double squares = 0.0;
+
+  void add(double value) {
+    sum += value;
+    squares += value * value;
+  }
+
+  Estimate estimate(uint32_t count, double z) const {
+    Estimate result;
+    if (count == 0) {
+      return result;
+    }
+    result.value = sum / count;
+    const double variance =
+        count > 1 ? std::max(0.0, (squares - sum * result.value) / (count - 1))
+                  : 0.0;
+    const double margin = z * std::sqrt(variance / count);
+    result.low = result.value - margin;
+    result.high = result.value + margin;
+    return result;
+  }
+};
+} // namespace
+
+Estimate wilson_interval(uint32_t successes, uint32_t trials, double z) {
+  Estimate result;
+  if (trials == 0) {
+    return result;
+  }
+  const double n = trials;
+  const double p = successes / n;
+  const double z2 = z * z;
+  const double center = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+  const double margin =
+      z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+  result.value = p;
+  result.low = std::max(0.0, center - margin);
+  result.high = std::min(1.0, center + margin);
+  return result;
+}
+
+Evaluator::Evaluator(const ai::QLearningAgent &policy,
+                     const EvaluationConfig &config)
+    : _policy(policy), _config(config) {
+  if (config.arena.max_episode_ticks == 0) {
+    throw std::runtime_error("Evaluation matches need a tick limit");
+  }
+
+  // Per-tick agent logging would dominate the match cost.
+  utils::Log::verbose() = false;
+
+  // The pool's workers play alongside the calling thread.
+  _threads = config.threads
+                 ? config.threads
+                 : std::max(1u, std::thread::hardware_concurrency());
+  if (_threads > 1) {
+    _pool.start(_threads - 1);
+  }
+}
+
+EvaluationReport Evaluator::evaluate(const ai::QLearningAgent *opponent) {
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<MatchResult> matches(_config.matches);
+  _pool.parallel_for(matches.size(), [&](size_t index) {
+    matches[index] = play(_config.seed + index, opponent);
+  });
+
+  EvaluationReport report;
+  report.matches = _config.matches;
+  Moments dealt, taken, length;
+  for (const MatchResult &match : matches) {
+    if (match.outcome > 0) {
+      ++report.wins;
+    } else if (match.outcome < 0) {
+      ++report.losses;
+    } else {
+      ++report.draws;
+    }
+    dealt.add(match.damage_dealt);
+    taken.add(match.damage_taken);
+    length.add(match.ticks * _config.arena.tick_seconds);
+  }
+  report.win_rate = wilson_interval(report.wins, report.matches, _config.z);
+  report.damage_dealt = dealt.estimate(report.matches, _config.z);
+  report.damage_taken = taken.estimate(report.matches, _config.z);
+  report.round_seconds = length.estimate(report.matches, _config.z);
+
+  report.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  report.threads = _threads;
+  return report;
+}
+
+// A fresh arena per match keeps matches independent of each other and of
+// which thread plays them.
+Evaluator::MatchResult
+Evaluator::play(uint64_t seed, const ai::QLearningAgent *opponent) const {
+  ArenaConfig config = _config.arena;
+  config.agent_control = true;
+  config.start_spread = _config.start_spread;
+  Arena arena(config);
+  arena.learner().swap_agent(frozen_copy(_policy));
+  arena.learner().set_learning(false);
+  if (opponent) {
+    arena.set_opponent_agent(frozen_copy(*opponent));
+  }
+  arena.reseed(seed);
+  arena.reset();
+
+  float reward = 0.0f;
+  while (!arena.step(ai::Action::IDLE, reward)) {
+  }
+
+  const auto &learner = arena.learner().state();
+  const auto &rival = arena.opponent().state();
+  MatchResult result;
+  result.outcome = arena.outcome();
+  result.damage_dealt = static_cast<float>(rival.max_health - rival.health);
+  result.damage_taken =
+      static_cast<float>(learner.max_health - learner.health);
+  result.ticks = arena.episode_ticks();
+  return result;
+}
+
+} // namespace env
+} // namespace wbz
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "env/arena.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wbz {
+namespace env {
+
+struct EvaluationConfig {
+  // Matches per opponent; match i is seeded with seed + i.
+  uint32_t matches = 1000;
+  uint64_t seed = 1;
+  // 1 plays on the calling thread, 0 uses every core.
+  size_t threads = 0;
+  // Normal quantile of the intervals, 1.96 for 95%.
+  double z = 1.96;
+  // Pixels the seed moves each fighter's start by. Two greedy policies
+  // would otherwise replay one identical match whatever the seed.
+  float start_spread = 100.0f;
+  // Matches end on a knockout or at max_episode_ticks, which must be set.
+  ArenaConfig arena;
+};
+
+// A point estimate and its confidence interval.
+struct Estimate {
+  double value = 0.0;
+  double low = 0.0;
+  double high = 0.0;
+};
+
+struct EvaluationReport {
+  uint32_t matches = 0;
+  uint32_t wins = 0;
+  uint32_t draws = 0;
+  uint32_t losses = 0;
+  // Wilson score interval, which stays inside [0, 1] near 0% and 100%.
+  Estimate win_rate;
+  // Means with normal intervals on the standard error.
+  Estimate damage_dealt;
+  Estimate damage_taken;
+  Estimate round_seconds;
+
+  double seconds = 0.0;
+  size_t threads = 1;
+  double matches_per_core_second() const {
+    return matches / seconds / threads;
+  }
+};
+
+Estimate wilson_interval(uint32_t successes, uint32_t trials, double z);
+
+// Plays a frozen policy, greedy and not learning, through independent
+// seeded matches in fresh arenas, either against the scripted opponent or
+// against another frozen policy in a mirror match. Matches are spread over
+// worker threads and reduced in match order, so a report does not depend
+// on the thread count.
+class Evaluator {
+public:
+  Evaluator(const ai::QLearningAgent &policy, const EvaluationConfig &config);
+
+  EvaluationReport against_scripted() { return evaluate(nullptr); }
+  EvaluationReport against(const ai::QLearningAgent &opponent) {
+    return evaluate(&opponent);
+  }
+
+private:
+  struct MatchResult {
+    int outcome = 0;
+    float damage_dealt = 0.0f;
+    float damage_taken = 0.0f;
+    uint32_t ticks = 0;
+  };
+
+  const ai::QLearningAgent &_policy;
+  EvaluationConfig _config;
+  utils::ThreadPool _pool;
+  size_t _threads = 1;
+
+  EvaluationReport evaluate(const ai::QLearningAgent *opponent);
+  MatchResult play(uint64_t seed, const ai::QLearningAgent *opponent) const;
+};
+
+} // namespace env
+} // namespace wbz
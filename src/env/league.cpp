@@ -0,0 +1,210 @@
+#include "league.hpp"
+#include "entities/character/ai_character.hpp"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace wbz {
+namespace env {
+
+namespace {
+const Vector2f FIRST_START(200.0f, 400.0f);
+const Vector2f SECOND_START(600.0f, 400.0f);
+} // namespace
+
+League::League(const LeagueConfig &config, uint64_t seed) : _config(config) {
+  if (config.agents < 2) {
+    throw std::runtime_error("A league needs at least two agents");
+  }
+
+  // Per-tick agent logging would dominate the match cost.
+  utils::Log::verbose() = false;
+
+  // Agents draw their random streams in order, so a seed reproduces them.
+  utils::Random::set_base_seed(seed);
+  _random = utils::Random::stream();
+  for (size_t i = 0; i < config.agents; ++i) {
+    LeagueMember member;
+    member.name = "agent" + std::to_string(i);
+    member.agent = std::make_unique<ai::QLearningAgent>();
+    _members.push_back(std::move(member));
+  }
+
+  // The pool's workers play alongside the calling thread.
+  const size_t threads =
+      config.threads ? config.threads
+                     : std::max(1u, std::thread::hardware_concurrency());
+  if (threads > 1) {
+    _pool.start(threads - 1);
+  }
+}
+
+LeagueRound League::play_round() {
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<size_t> order(_members.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  for (size_t i = order.size() - 1; i > 0; --i) {
+    std::swap(order[i], order[_random.range(0, static_cast<int>(i))]);
+  }
+
+  // Snapshots only matter as opponents for learners.
+  std::vector<Match> matches;
+  for (size_t i = 0; i + 1 < order.size(); i += 2) {
+    if (!_members[order[i]].frozen || !_members[order[i + 1]].frozen) {
+      matches.push_back({order[i], order[i + 1]});
+    }
+  }
+
+  _pool.parallel_for(matches.size(),
+                     [&](size_t index) { play(matches[index]); });
+
+  LeagueRound round;
+  for (const Match &match : matches) {
+    rate(match);
+    round.ticks += match.ticks;
+  }
+  round.matches = static_cast<uint32_t>(matches.size());
+  _matches += matches.size();
+  ++_rounds;
+
+  if (_config.snapshot_interval && _rounds % _config.snapshot_interval == 0) {
+    snapshot();
+  }
+
+  round.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return round;
+}
+
+void League::play(Match &match) {
+  Sprite sprite("goku_ssjb.png", {64, 2271, 64, 64}, {0, 0, 64, 64});
+  entities::CombatStats stats(100, 100, 450.0f, 750.0f, 1.2f, 12, 0.9f);
+  entities::AICharacter first(sprite, stats);
+  entities::AICharacter second(sprite, stats);
+  LeagueMember &first_member = _members[match.first];
+  LeagueMember &second_member = _members[match.second];
+
+  // The members' agents play for the length of the match.
+  auto first_spare = first.swap_agent(std::move(first_member.agent));
+  auto second_spare = second.swap_agent(std::move(second_member.agent));
+
+  ai::DecisionScheduler decisions(_config.decision_interval);
+  for (auto *character : {&first, &second}) {
+    character->set_episode_logging(false);
+    character->set_decision_scheduler(&decisions);
+  }
+  first.set_learning(!first_member.frozen);
+  second.set_learning(!second_member.frozen);
+  first.mover().set_position(FIRST_START);
+  second.mover().set_position(SECOND_START);
+  first.set_opponent(&second);
+  second.set_opponent(&first);
+  first.stare_at(&second.mover().position());
+  second.stare_at(&first.mover().position());
+
+  uint32_t tick = 0;
+  while (tick < _config.match_ticks && first.state().is_alive() &&
+         second.state().is_alive()) {
+    const uint32_t first_attacks = first.attacks_started();
+    const uint32_t second_attacks = second.attacks_started();
+
+    decisions.begin_tick();
+    first.update(_config.tick_seconds);
+    second.update(_config.tick_seconds);
+
+    if (first.attacks_started() != first_attacks) {
+      entities::resolve_attack(first, second);
+    }
+    if (second.attacks_started() != second_attacks) {
+      entities::resolve_attack(second, first);
+    }
+    ++tick;
+  }
+
+  // Time-outs go to whoever has more health left.
+  const float first_health =
+      static_cast<float>(first.state().health) / first.state().max_health;
+  const float second_health =
+      static_cast<float>(second.state().health) / second.state().max_health;
+  match.outcome = first_health > second_health   ? 1
+                  : first_health < second_health ? -1
+                                                 : 0;
+  match.ticks = tick;
+
+  first_member.agent = first.swap_agent(std::move(first_spare));
+  second_member.agent = second.swap_agent(std::move(second_spare));
+}
+
+void League::rate(const Match &match) {
+  LeagueMember &first = _members[match.first];
+  LeagueMember &second = _members[match.second];
+
+  const double expected =
+      1.0 / (1.0 + std::pow(10.0, (second.rating - first.rating) / 400.0));
+  const double score = match.outcome > 0 ? 1.0 : match.outcome < 0 ? 0.0 : 0.5;
+  const double change = _config.elo_k * (score - expected);
+  first.rating += change;
+  second.rating -= change;
+
+  if (match.outcome > 0) {
+    ++first.wins;
+    ++second.losses;
+  } else if (match.outcome < 0) {
+    ++first.losses;
+    ++second.wins;
+  } else {
+    ++first.draws;
+    ++second.draws;
+  }
+}
+
+// Freezes a copy of the best-rated learner into the population, replacing
+// the oldest snapshot once there are max_snapshots of them.
+void League::snapshot() {
+  if (_config.max_snapshots == 0) {
+    return;
+  }
+
+  const LeagueMember *best = nullptr;
+  size_t snapshots = 0;
+  for (const auto &member : _members) {
+    if (member.frozen) {
+      ++snapshots;
+    } else if (!best || member.rating > best->rating) {
+      best = &member;
+    }
+  }
+
+  LeagueMember frozen;
+  frozen.name = best->name + "@" + std::to_string(_rounds);
+  frozen.agent = std::make_unique<ai::QLearningAgent>();
+  frozen.agent->copy_table(*best->agent);
+  frozen.rating = best->rating;
+  frozen.frozen = true;
+
+  if (!_config.snapshot_dir.empty()) {
+    frozen.agent->save_table(_config.snapshot_dir + "/" + frozen.name +
+                             ".qtable");
+  }
+
+  if (snapshots >= _config.max_snapshots) {
+    for (auto it = _members.begin(); it != _members.end(); ++it) {
+      if (it->frozen) {
+        _members.erase(it);
+        break;
+      }
+    }
+  }
+  _members.push_back(std::move(frozen));
+}
+
+} // namespace env
+} // namespace wbz
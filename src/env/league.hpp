@@ -0,0 +1,87 @@
+#pragma once
+
+#include "entities/agent/QLearningAgent.hpp"
+#include "utils/random.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wbz {
+namespace env {
+
+struct LeagueConfig {
+  // Learning agents; frozen snapshots are added on top of these.
+  size_t agents = 8;
+  // Matches end on a knockout or after this many ticks.
+  uint32_t match_ticks = 120 * 30;
+  double tick_seconds = 1.0 / 120.0;
+  uint32_t decision_interval = 4;
+  // 1 plays on the calling thread, 0 uses every core.
+  size_t threads = 0;
+  // Every this many rounds the best learner is frozen into a snapshot, 0
+  // for never.
+  uint32_t snapshot_interval = 10;
+  size_t max_snapshots = 8;
+  // Snapshots are also saved here as Q-tables, if set.
+  std::string snapshot_dir;
+  float elo_k = 32.0f;
+};
+
+struct LeagueMember {
+  std::string name;
+  std::unique_ptr<ai::QLearningAgent> agent;
+  double rating = 1000.0;
+  // Snapshots play their policy without learning.
+  bool frozen = false;
+  uint32_t wins = 0;
+  uint32_t losses = 0;
+  uint32_t draws = 0;
+};
+
+struct LeagueRound {
+  uint32_t matches = 0;
+  uint64_t ticks = 0;
+  double seconds = 0.0;
+};
+
+// Self-play league: a population of Q-learning agents fought against each
+// other in pairs, two AI characters per match with no rendering. Each
+// round pairs the population at random and plays the matches across worker
+// threads, then updates Elo ratings in pairing order. A match only touches
+// its own two agents, so results do not depend on the thread count.
+class League {
+public:
+  League(const LeagueConfig &config, uint64_t seed);
+
+  LeagueRound play_round();
+
+  const std::vector<LeagueMember> &members() const { return _members; }
+  uint32_t rounds() const { return _rounds; }
+  uint64_t matches() const { return _matches; }
+
+private:
+  struct Match {
+    size_t first;
+    size_t second;
+    // 1 when first won, -1 when second won, 0 for a draw.
+    int outcome = 0;
+    uint32_t ticks = 0;
+  };
+
+  LeagueConfig _config;
+  std::vector<LeagueMember> _members;
+  utils::Random _random;
+  utils::ThreadPool _pool;
+  uint32_t _rounds = 0;
+  uint64_t _matches = 0;
+
+  void play(Match &match);
+  void rate(const Match &match);
+  void snapshot();
+};
+
+} // namespace env
+} // namespace wbz
@@ -0,0 +1,280 @@
+#include "shm_channel.hpp"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace wbz {
+namespace env {
+
+namespace {
+constexpr size_t LINE = 64;
+// Polls before falling back to the futex; a lockstep peer usually answers
+// within this many iterations.
+constexpr int SPIN_ITERATIONS = 4000;
+
+size_t round_up(size_t size) { return (size + LINE - 1) / LINE * LINE; }
+
+uint32_t load(const uint32_t *word) {
+  return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+void futex_wait(uint32_t *word, uint32_t value) {
+  // Wake up now and then to notice a peer that closed or died.
+  timespec timeout = {0, 100 * 1000 * 1000};
+  syscall(SYS_futex, word, FUTEX_WAIT, value, &timeout, nullptr, 0);
+}
+
+void futex_wake(uint32_t *word) {
+  syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+} // namespace
+
+ShmChannel &ShmChannel::operator=(ShmChannel &&other) noexcept {
+  if (this != &other) {
+    close();
+    _header = std::exchange(other._header, nullptr);
+    _size = std::exchange(other._size, 0);
+    _name = std::move(other._name);
+    _owner = std::exchange(other._owner, false);
+  }
+  return *this;
+}
+
+std::string ShmChannel::segment_name(const std::string &name, size_t index) {
+  return "/wbz_env_" + name + "_" + std::to_string(index);
+}
+
+ShmChannel ShmChannel::create(const std::string &name, uint32_t arenas,
+                              uint32_t observation_size, uint32_t slots) {
+  const size_t request_size = round_up(8 + sizeof(int32_t) * arenas);
+  const size_t response_size = round_up(
+      8 + sizeof(float) * arenas * (observation_size + 1) + arenas);
+  const size_t size =
+      sizeof(wbz_shm_header) + slots * (request_size + response_size);
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to create shared memory " + name);
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error("Failed to size shared memory " + name);
+  }
+
+  void *memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::runtime_error("Failed to map shared memory " + name);
+  }
+
+  ShmChannel channel;
+  channel._header = static_cast<wbz_shm_header *>(memory);
+  channel._size = size;
+  channel._name = name;
+  channel._owner = true;
+
+  // ftruncate zero-fills, so only the layout needs writing.
+  wbz_shm_header *header = channel._header;
+  header->magic = WBZ_SHM_MAGIC;
+  header->version = WBZ_SHM_VERSION;
+  header->num_arenas = arenas;
+  header->observation_size = observation_size;
+  header->slot_count = slots;
+  header->request_slot_size = static_cast<uint32_t>(request_size);
+  header->response_slot_size = static_cast<uint32_t>(response_size);
+  __atomic_store_n(&header->state, WBZ_SHM_READY, __ATOMIC_RELEASE);
+  return channel;
+}
+
+ShmChannel ShmChannel::open(const std::string &name, int timeout_ms) {
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+
+  for (;;) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0 &&
+        static_cast<size_t>(info.st_size) >= sizeof(wbz_shm_header)) {
+      void *memory = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (memory == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shared memory " + name);
+      }
+
+      ShmChannel channel;
+      channel._header = static_cast<wbz_shm_header *>(memory);
+      channel._size = info.st_size;
+      channel._name = name;
+      if (load(&channel._header->state) == WBZ_SHM_READY) {
+        if (channel._header->magic != WBZ_SHM_MAGIC ||
+            channel._header->version != WBZ_SHM_VERSION) {
+          throw std::runtime_error("Not an environment segment: " + name);
+        }
+        return channel;
+      }
+    } else if (fd >= 0) {
+      ::close(fd);
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      throw std::runtime_error("No environment server at " + name);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+void ShmChannel::close() {
+  if (!_header) {
+    return;
+  }
+  if (_owner) {
+    mark_closed();
+    shm_unlink(_name.c_str());
+  }
+  munmap(_header, _size);
+  _header = nullptr;
+  _owner = false;
+}
+
+void ShmChannel::mark_closed() {
+  __atomic_store_n(&_header->state, WBZ_SHM_CLOSED, __ATOMIC_RELEASE);
+  for (uint32_t *word : {&_header->request_head, &_header->request_tail,
+                         &_header->response_head, &_header->response_tail}) {
+    futex_wake(word);
+  }
+}
+
+uint8_t *ShmChannel::request_slot(uint32_t index) const {
+  return reinterpret_cast<uint8_t *>(_header + 1) +
+         static_cast<size_t>(index % _header->slot_count) *
+             _header->request_slot_size;
+}
+
+uint8_t *ShmChannel::response_slot(uint32_t index) const {
+  return reinterpret_cast<uint8_t *>(_header + 1) +
+         static_cast<size_t>(_header->slot_count) *
+             _header->request_slot_size +
+         static_cast<size_t>(index % _header->slot_count) *
+             _header->response_slot_size;
+}
+
+ShmChannel::Request ShmChannel::request_at(uint8_t *slot) const {
+  return {reinterpret_cast<uint32_t *>(slot),
+          reinterpret_cast<int32_t *>(slot + 8)};
+}
+
+ShmChannel::Response ShmChannel::response_at(uint8_t *slot) const {
+  const size_t arenas = _header->num_arenas;
+  float *observations = reinterpret_cast<float *>(slot + 8);
+  float *rewards = observations + arenas * _header->observation_size;
+  return {reinterpret_cast<uint32_t *>(slot), observations, rewards,
+          reinterpret_cast<uint8_t *>(rewards + arenas)};
+}
+
+void ShmChannel::wait_change(uint32_t *word, uint32_t *waiters,
+                             uint32_t value) const {
+  for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+    if (load(word) != value) {
+      return;
+    }
+    cpu_relax();
+  }
+
+  for (;;) {
+    __atomic_store_n(waiters, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(word, __ATOMIC_SEQ_CST) != value) {
+      return;
+    }
+    if (load(&_header->state) == WBZ_SHM_CLOSED) {
+      throw std::runtime_error("Environment channel closed: " + _name);
+    }
+    futex_wait(word, value);
+  }
+}
+
+void ShmChannel::publish(uint32_t *word, uint32_t *waiters, uint32_t value) {
+  __atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+  if (__atomic_exchange_n(waiters, 0, __ATOMIC_SEQ_CST)) {
+    futex_wake(word);
+  }
+}
+
+ShmChannel::Request ShmChannel::begin_request() {
+  const uint32_t head = _header->request_head;
+  wbz_shm_header *h = _header;
+  // Full ring: wait for the server to consume a slot.
+  uint32_t tail;
+  while (head - (tail = load(&h->request_tail)) >= h->slot_count) {
+    wait_change(&h->request_tail, &h->request_tail_waiters, tail);
+  }
+  return request_at(request_slot(head));
+}
+
+void ShmChannel::end_request() {
+  publish(&_header->request_head, &_header->request_head_waiters,
+          _header->request_head + 1);
+}
+
+ShmChannel::Response ShmChannel::wait_response() {
+  const uint32_t tail = _header->response_tail;
+  wait_change(&_header->response_head, &_header->response_head_waiters, tail);
+  return response_at(response_slot(tail));
+}
+
+void ShmChannel::release_response() {
+  publish(&_header->response_tail, &_header->response_tail_waiters,
+          _header->response_tail + 1);
+}
+
+ShmChannel::Request ShmChannel::wait_request() {
+  const uint32_t tail = _header->request_tail;
+  wait_change(&_header->request_head, &_header->request_head_waiters, tail);
+  return request_at(request_slot(tail));
+}
+
+void ShmChannel::release_request() {
+  publish(&_header->request_tail, &_header->request_tail_waiters,
+          _header->request_tail + 1);
+}
+
+ShmChannel::Response ShmChannel::begin_response() {
+  const uint32_t head = _header->response_head;
+  wbz_shm_header *h = _header;
+  uint32_t tail;
+  while (head - (tail = load(&h->response_tail)) >= h->slot_count) {
+    wait_change(&h->response_tail, &h->response_tail_waiters, tail);
+  }
+  return response_at(response_slot(head));
+}
+
+void ShmChannel::end_response() {
+  publish(&_header->response_head, &_header->response_head_waiters,
+          _header->response_head + 1);
+}
+
+} // namespace env
+} // namespace wbz
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "env/wbz_env_shm.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace wbz {
+namespace env {
+
+// One environment's shared memory segment, as laid out in wbz_env_shm.h.
+// The server creates it and the client opens it; both sides then exchange
+// slots through the request and response rings. Waits spin briefly before
+// sleeping on a futex, so a lockstep round trip usually costs no syscall
+// on the waiting side. Linux only.
+class ShmChannel {
+public:
+  struct Request {
+    uint32_t *command;
+    int32_t *actions;
+  };
+
+  struct Response {
+    uint32_t *status;
+    float *observations;
+    float *rewards;
+    uint8_t *dones;
+  };
+
+  ShmChannel() = default;
+  ~ShmChannel() { close(); }
+
+  ShmChannel(ShmChannel &&other) noexcept { *this = std::move(other); }
+  ShmChannel &operator=(ShmChannel &&other) noexcept;
+  ShmChannel(const ShmChannel &) = delete;
+  ShmChannel &operator=(const ShmChannel &) = delete;
+
+  // Server side: creates (replacing any stale segment) and owns the name.
+  static ShmChannel create(const std::string &name, uint32_t arenas,
+                           uint32_t observation_size, uint32_t slots = 4);
+  // Client side: waits up to timeout_ms for the server to be ready.
+  static ShmChannel open(const std::string &name, int timeout_ms = 5000);
+
+  static std::string segment_name(const std::string &name, size_t index);
+
+  void close();
+  // Tells waiting peers the session is over.
+  void mark_closed();
+
+  uint32_t arenas() const { return _header->num_arenas; }
+  uint32_t observation_size() const { return _header->observation_size; }
+
+  // Client side.
+  Request begin_request();
+  void end_request();
+  Response wait_response();
+  void release_response();
+
+  // Server side.
+  Request wait_request();
+  void release_request();
+  Response begin_response();
+  void end_response();
+
+private:
+  wbz_shm_header *_header = nullptr;
+  size_t _size = 0;
+  std::string _name;
+  bool _owner = false;
+
+  uint8_t *request_slot(uint32_t index) const;
+  uint8_t *response_slot(uint32_t index) const;
+  Request request_at(uint8_t *slot) const;
+  Response response_at(uint8_t *slot) const;
+
+  // Waits until *word differs from value.
+  void wait_change(uint32_t *word, uint32_t *waiters, uint32_t value) const;
+  static void publish(uint32_t *word, uint32_t *waiters, uint32_t value);
+};
+
+} // namespace env
+} // namespace wbz
@@ -0,0 +1,333 @@
+#include "sweep.hpp"
+#include "utils/log.hpp"
+#include "utils/random.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace wbz {
+namespace env {
+
+namespace {
+struct ParamField {
+  const char *name;
+  float ai::AgentParams::*field;
+};
+
+const ParamField PARAM_FIELDS[] = {
+    {"learning_rate", &ai::AgentParams::learning_rate},
+    {"discount_factor", &ai::AgentParams::discount_factor},
+    {"exploration_rate", &ai::AgentParams::exploration_rate},
+    {"exploration_decay", &ai::AgentParams::exploration_decay},
+    {"min_exploration_rate", &ai::AgentParams::min_exploration_rate},
+    {"optimal_distance", &ai::AgentParams::optimal_distance},
+    {"close_range", &ai::AgentParams::close_range},
+    {"far_range", &ai::AgentParams::far_range},
+    {"approach_reward", &ai::AgentParams::approach_reward},
+    {"hit_reward", &ai::AgentParams::hit_reward},
+    {"got_hit_penalty", &ai::AgentParams::got_hit_penalty},
+    {"out_of_radar_penalty", &ai::AgentParams::out_of_radar_penalty},
+    {"inactivity_penalty", &ai::AgentParams::inactivity_penalty},
+};
+
+float ai::AgentParams::*find_field(const std::string &name) {
+  for (const auto &param : PARAM_FIELDS) {
+    if (name == param.name) {
+      return param.field;
+    }
+  }
+  return nullptr;
+}
+
+std::string trim(const std::string &text) {
+  const size_t begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+// Pins the calling thread to a core; best effort, since the process may be
+// restricted to fewer cores than it sees.
+void pin_to_core(size_t core) {
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % CPU_SETSIZE, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)core;
+#endif
+}
+} // namespace
+
+SweepSpec SweepSpec::parse(std::istream &input) {
+  SweepSpec spec;
+  std::string line;
+  for (int number = 1; std::getline(input, line); ++number) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+
+    const size_t equals = line.find('=');
+    if (equals == std::string::npos) {
+      throw std::runtime_error("Sweep spec line " + std::to_string(number) +
+                               ": expected key = value");
+    }
+    const std::string key = trim(line.substr(0, equals));
+    const std::string value = trim(line.substr(equals + 1));
+    std::istringstream fields(value);
+
+    try {
+      if (key == "mode") {
+        std::string mode;
+        fields >> mode;
+        if (mode == "grid") {
+          spec.samples = 0;
+        } else if (mode != "random" || !(fields >> spec.samples) ||
+                   spec.samples == 0) {
+          throw std::runtime_error("expected grid or random <count>");
+        }
+      } else if (key == "seeds") {
+        spec.seeds = static_cast<uint32_t>(std::stoul(value));
+      } else if (key == "seed") {
+        spec.seed = std::stoull(value);
+      } else if (key == "ticks") {
+        spec.ticks = std::stoull(value);
+      } else if (find_field(key)) {
+        SweepParameter param;
+        param.name = key;
+        const size_t dots = value.find("..");
+        if (dots != std::string::npos) {
+          param.low = std::stof(value.substr(0, dots));
+          param.high = std::stof(value.substr(dots + 2));
+        } else {
+          float v;
+          while (fields >> v) {
+            param.values.push_back(v);
+          }
+          if (param.values.empty() || !fields.eof()) {
+            throw std::runtime_error("expected a list of numbers");
+          }
+        }
+        spec.parameters.push_back(param);
+      } else {
+        throw std::runtime_error("unknown key '" + key + "'");
+      }
+    } catch (const std::logic_error &) {
+      // std::stoul and friends throw invalid_argument and out_of_range.
+      throw std::runtime_error("Sweep spec line " + std::to_string(number) +
+                               ": bad value '" + value + "'");
+    } catch (const std::runtime_error &e) {
+      throw std::runtime_error("Sweep spec line " + std::to_string(number) +
+                               ": " + e.what());
+    }
+  }
+
+  if (spec.seeds == 0) {
+    throw std::runtime_error("Sweep spec needs at least one seed");
+  }
+  for (const auto &param : spec.parameters) {
+    if (param.values.empty() && spec.samples == 0) {
+      throw std::runtime_error("Range for " + param.name +
+                               " needs mode = random");
+    }
+  }
+  return spec;
+}
+
+SweepSpec SweepSpec::load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Failed to open sweep spec: " + path);
+  }
+  return parse(file);
+}
+
+float SweepSpec::value(const ai::AgentParams &params,
+                       const std::string &name) {
+  auto field = find_field(name);
+  if (!field) {
+    throw std::runtime_error("Unknown sweep parameter: " + name);
+  }
+  return params.*field;
+}
+
+Sweep::Sweep(const SweepSpec &spec) : _spec(spec) {
+  std::vector<ai::AgentParams> configurations;
+  if (spec.samples == 0) {
+    // Full grid, the last parameter varying fastest.
+    size_t count = 1;
+    for (const auto &param : spec.parameters) {
+      count *= param.values.size();
+    }
+    for (size_t index = 0; index < count; ++index) {
+      ai::AgentParams params;
+      size_t rest = index;
+      for (auto it = spec.parameters.rbegin(); it != spec.parameters.rend();
+           ++it) {
+        params.*find_field(it->name) = it->values[rest % it->values.size()];
+        rest /= it->values.size();
+      }
+      configurations.push_back(params);
+    }
+  } else {
+    utils::Random random(spec.seed, 0);
+    for (uint32_t sample = 0; sample < spec.samples; ++sample) {
+      ai::AgentParams params;
+      for (const auto &param : spec.parameters) {
+        params.*find_field(param.name) =
+            param.values.empty()
+                ? param.low + random.uniform() * (param.high - param.low)
+                : param.values[random.range(
+                      0, static_cast<int>(param.values.size()) - 1)];
+      }
+      configurations.push_back(params);
+    }
+  }
+
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    for (uint32_t s = 0; s < spec.seeds; ++s) {
+      _jobs.push_back({i, spec.seed + _jobs.size(), configurations[i]});
+    }
+  }
+}
+
+std::vector<SweepResult> Sweep::run(size_t threads) const {
+  // Per-tick agent logging would dominate the run cost.
+  utils::Log::verbose() = false;
+
+  const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  if (threads == 0) {
+    threads = cores;
+  }
+  threads = std::max<size_t>(1, std::min(threads, _jobs.size()));
+
+  std::vector<SweepResult> results(_jobs.size());
+  std::atomic<size_t> next{0};
+  auto work = [&] {
+    for (size_t job = next++; job < _jobs.size(); job = next++) {
+      results[job] = run_job(_jobs[job]);
+    }
+  };
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+  if (threads > 1) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+      workers.emplace_back([&, i] {
+        pin_to_core(i % cores);
+        work();
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    return results;
+  }
+#endif
+  work();
+  return results;
+}
+
+SweepResult Sweep::run_job(const SweepJob &job) const {
+  const auto start = std::chrono::steady_clock::now();
+
+  ArenaConfig config = _spec.arena;
+  config.agent_control = true;
+  config.agent = job.params;
+  Arena arena(config);
+  arena.reseed(job.seed);
+
+  std::vector<float> episode_rewards;
+  std::vector<bool> episode_wins;
+  float episode_reward = 0.0f;
+  while (arena.ticks() < _spec.ticks) {
+    const uint64_t wins = arena.wins();
+    float reward = 0.0f;
+    const bool done = arena.step(ai::Action::IDLE, reward);
+    episode_reward += reward;
+    if (done) {
+      episode_rewards.push_back(episode_reward);
+      episode_wins.push_back(arena.wins() != wins);
+      episode_reward = 0.0f;
+      arena.reset();
+    }
+  }
+
+  SweepResult result;
+  result.episodes = arena.episodes();
+  result.wins = arena.wins();
+
+  const size_t episodes = episode_rewards.size();
+  const size_t tail = std::max<size_t>(1, episodes / 5);
+  if (episodes > 0) {
+    result.final_win_rate =
+        static_cast<float>(std::count(episode_wins.end() - tail,
+                                      episode_wins.end(), true)) /
+        tail;
+  }
+  for (size_t point = 0; point < CURVE_POINTS; ++point) {
+    const size_t begin = episodes * point / CURVE_POINTS;
+    const size_t end = episodes * (point + 1) / CURVE_POINTS;
+    float sum = 0.0f;
+    for (size_t i = begin; i < end; ++i) {
+      sum += episode_rewards[i];
+    }
+    result.reward_curve.push_back(
+        end > begin ? sum / (end - begin)
+                    : std::numeric_limits<float>::quiet_NaN());
+  }
+
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+void Sweep::write_csv(const std::string &path,
+                      const std::vector<SweepResult> &results) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Failed to write sweep results: " + path);
+  }
+
+  file << "job,configuration,seed";
+  for (const auto &param : _spec.parameters) {
+    file << "," << param.name;
+  }
+  file << ",episodes,wins,final_win_rate";
+  for (size_t point = 0; point < CURVE_POINTS; ++point) {
+    file << ",reward_" << point;
+  }
+  file << ",seconds\n";
+
+  for (size_t i = 0; i < _jobs.size(); ++i) {
+    const SweepJob &job = _jobs[i];
+    const SweepResult &result = results[i];
+    file << i << "," << job.configuration << "," << job.seed;
+    for (const auto &param : _spec.parameters) {
+      file << "," << SweepSpec::value(job.params, param.name);
+    }
+    file << "," << result.episodes << "," << result.wins << ","
+         << result.final_win_rate;
+    for (float reward : result.reward_curve) {
+      file << "," << reward;
+    }
+    file << "," << result.seconds << "\n";
+  }
+}
+
+} // namespace env
+} // namespace wbz
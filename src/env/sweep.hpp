@@ -0,0 +1,93 @@
+#pragma once
+
+#include "env/arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace wbz {
+namespace env {
+
+// One swept AgentParams field: either a list of values or, for random
+// search, a range sampled uniformly.
+struct SweepParameter {
+  std::string name;
+  std::vector<float> values;
+  float low = 0.0f;
+  float high = 0.0f;
+};
+
+// Parsed from lines of `key = value`, with # comments:
+//
+//   mode = grid            or  mode = random 32
+//   seeds = 3              runs per configuration
+//   seed = 1               first job seed; job i uses seed + i
+//   ticks = 432000         training ticks per run
+//   learning_rate = 0.05 0.1 0.2
+//   exploration_decay = 0.99..0.999
+//
+// Any AgentParams field can be swept; ranges need random mode.
+struct SweepSpec {
+  std::vector<SweepParameter> parameters;
+  // Random search draws this many configurations, 0 for a full grid.
+  uint32_t samples = 0;
+  uint32_t seeds = 1;
+  uint64_t seed = 1;
+  uint64_t ticks = 120 * 60 * 60;
+  ArenaConfig arena;
+
+  static SweepSpec parse(std::istream &input);
+  static SweepSpec load(const std::string &path);
+
+  // The AgentParams field a parameter name refers to.
+  static float value(const ai::AgentParams &params, const std::string &name);
+};
+
+struct SweepJob {
+  size_t configuration;
+  uint64_t seed;
+  ai::AgentParams params;
+};
+
+struct SweepResult {
+  uint64_t episodes = 0;
+  uint64_t wins = 0;
+  // Win rate over the last fifth of the run's episodes.
+  float final_win_rate = 0.0f;
+  // Mean episode reward over CURVE_POINTS equal spans of the episodes; NaN
+  // for spans without an episode, when a run has fewer than CURVE_POINTS.
+  std::vector<float> reward_curve;
+  double seconds = 0.0;
+};
+
+// Hyperparameter sweep: every configuration of the spec trained once per
+// seed, each run its own headless arena with the learner's agent in
+// control against the scripted opponent. Runs are spread over worker
+// threads pinned to cores, and since each is seeded by its job index the
+// results do not depend on the thread count.
+class Sweep {
+public:
+  static constexpr size_t CURVE_POINTS = 10;
+
+  explicit Sweep(const SweepSpec &spec);
+
+  const std::vector<SweepJob> &jobs() const { return _jobs; }
+  const SweepSpec &spec() const { return _spec; }
+
+  // threads == 0 uses every core.
+  std::vector<SweepResult> run(size_t threads) const;
+
+  void write_csv(const std::string &path,
+                 const std::vector<SweepResult> &results) const;
+
+private:
+  SweepSpec _spec;
+  std::vector<SweepJob> _jobs;
+
+  SweepResult run_job(const SweepJob &job) const;
+};
+
+} // namespace env
+} // namespace wbz
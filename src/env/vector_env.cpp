@@ -0,0 +1,80 @@
+#include "vector_env.hpp"
+#include "utils/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace wbz {
+namespace env {
+
+VectorEnv::VectorEnv(size_t arena_count, const ArenaConfig &config,
+                     size_t threads, uint64_t seed) {
+  if (arena_count == 0) {
+    throw std::runtime_error("A vector env needs at least one arena");
+  }
+
+  // Per-tick agent logging would dominate the step cost.
+  utils::Log::verbose() = false;
+
+  // Arenas draw their random streams in order, so a seed reproduces them.
+  utils::Random::set_base_seed(seed);
+  _arenas.reserve(arena_count);
+  for (size_t i = 0; i < arena_count; ++i) {
+    _arenas.emplace_back(config);
+  }
+
+  // The pool's workers step alongside the calling thread.
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (threads > 1) {
+    _pool.start(threads - 1);
+  }
+}
+
+void VectorEnv::reset(float *observations) {
+  for (size_t i = 0; i < _arenas.size(); ++i) {
+    _arenas[i].reset();
+    _arenas[i].observe(observations + i * Arena::OBSERVATION_SIZE);
+  }
+}
+
+void VectorEnv::step(const int32_t *actions, float *observations,
+                     float *rewards, uint8_t *dones) {
+  const int32_t action_count = static_cast<int32_t>(ai::Action::ACTION_COUNT);
+  for (size_t i = 0; i < _arenas.size(); ++i) {
+    if (actions[i] < 0 || actions[i] >= action_count) {
+      throw std::runtime_error("Action out of range for arena " +
+                               std::to_string(i));
+    }
+  }
+
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  const auto start = clock::now();
+
+  _pool.parallel_for(_arenas.size(), [&](size_t i) {
+    Arena &arena = _arenas[i];
+    const bool done =
+        arena.step(static_cast<ai::Action>(actions[i]), rewards[i]);
+    dones[i] = done;
+    if (done) {
+      arena.reset();
+    }
+  });
+
+  const auto simulated = clock::now();
+
+  for (size_t i = 0; i < _arenas.size(); ++i) {
+    _arenas[i].observe(observations + i * Arena::OBSERVATION_SIZE);
+  }
+
+  const auto end = clock::now();
+  ++_timings.steps;
+  _timings.simulate_ms += ms(simulated - start).count();
+  _timings.marshal_ms += ms(end - simulated).count();
+}
+
+} // namespace env
+} // namespace wbz
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "env/arena.hpp"
+#include "utils/thread_pool.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace wbz {
+namespace env {
+
+// Time spent inside step(), split into simulating the arenas and packing
+// their results into the caller's buffers.
+struct StepTimings {
+  uint64_t steps = 0;
+  double simulate_ms = 0.0;
+  double marshal_ms = 0.0;
+};
+
+// N independent arenas stepped together. Observations, rewards and done
+// flags are written into caller-owned buffers laid out arena by arena, and
+// arenas whose episode ended are reset within the same step, so the
+// observation returned for them is the first of the next episode.
+class VectorEnv {
+public:
+  // threads == 1 steps on the calling thread, 0 uses every core.
+  VectorEnv(size_t arena_count, const ArenaConfig &config, size_t threads,
+            uint64_t seed);
+
+  size_t size() const { return _arenas.size(); }
+  const Arena &arena(size_t index) const { return _arenas[index]; }
+
+  void reset(float *observations);
+  void step(const int32_t *actions, float *observations, float *rewards,
+            uint8_t *dones);
+
+  const StepTimings &timings() const { return _timings; }
+
+private:
+  std::vector<Arena> _arenas;
+  utils::ThreadPool _pool;
+  StepTimings _timings;
+};
+
+} // namespace env
+} // namespace wbz
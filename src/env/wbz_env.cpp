@@ -0,0 +1,99 @@
+#include "wbz_env.h"
+#include "env/vector_env.hpp"
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+static_assert(WBZ_ENV_OBSERVATION_SIZE == wbz::env::Arena::OBSERVATION_SIZE,
+              "Observation size out of sync with the C header");
+static_assert(WBZ_ENV_ACTION_COUNT ==
+                  static_cast<int>(wbz::ai::Action::ACTION_COUNT),
+              "Action count out of sync with the C header");
+
+struct wbz_env {
+  wbz::env::VectorEnv env;
+
+  wbz_env(size_t arena_count, const wbz::env::ArenaConfig &config,
+          size_t threads, uint64_t seed)
+      : env(arena_count, config, threads, seed) {}
+};
+
+namespace {
+thread_local std::string last_error;
+
+// Exceptions must not cross the C boundary.
+template <typename Fn> int guarded(Fn &&fn) {
+  try {
+    fn();
+    return 0;
+  } catch (const std::exception &e) {
+    last_error = e.what();
+  } catch (...) {
+    last_error = "Unknown error";
+  }
+  return -1;
+}
+} // namespace
+
+extern "C" {
+
+wbz_env *wbz_env_create(const wbz_env_config *config) {
+  wbz_env *env = nullptr;
+  guarded([&] {
+    if (!config) {
+      throw std::runtime_error("Missing config");
+    }
+
+    wbz::env::ArenaConfig arena;
+    arena.frame_skip = config->frame_skip ? config->frame_skip : 4;
+    arena.max_episode_ticks = config->max_episode_ticks;
+    arena.tick_seconds = 1.0 / (config->tick_rate ? config->tick_rate : 120);
+    env = new wbz_env(config->num_arenas, arena, config->num_threads,
+                      config->seed);
+  });
+  return env;
+}
+
+void wbz_env_destroy(wbz_env *env) { delete env; }
+
+uint32_t wbz_env_num_arenas(const wbz_env *env) {
+  return env ? static_cast<uint32_t>(env->env.size()) : 0;
+}
+
+int wbz_env_reset(wbz_env *env, float *observations) {
+  return guarded([&] {
+    if (!env || !observations) {
+      throw std::runtime_error("Missing env or observation buffer");
+    }
+    env->env.reset(observations);
+  });
+}
+
+int wbz_env_step(wbz_env *env, const int32_t *actions, float *observations,
+                 float *rewards, uint8_t *dones) {
+  return guarded([&] {
+    if (!env || !actions || !observations || !rewards || !dones) {
+      throw std::runtime_error("Missing env or step buffer");
+    }
+    env->env.step(actions, observations, rewards, dones);
+  });
+}
+
+void wbz_env_get_stats(const wbz_env *env, wbz_env_stats *stats) {
+  if (!env || !stats) {
+    return;
+  }
+
+  const auto &timings = env->env.timings();
+  *stats = {};
+  stats->steps = timings.steps;
+  stats->simulate_ms = timings.simulate_ms;
+  stats->marshal_ms = timings.marshal_ms;
+  for (size_t i = 0; i < env->env.size(); ++i) {
+    stats->episodes += env->env.arena(i).episodes();
+    stats->ticks += env->env.arena(i).ticks();
+  }
+}
+
+const char *wbz_env_last_error(void) { return last_error.c_str(); }
+}
@@ -0,0 +1,68 @@
+/* C interface to the vectorized training environment, built as
+ * libwbz_env by `make env`. All buffers are owned by the caller and laid
+ * out arena by arena:
+ *   observations  float[num_arenas * WBZ_ENV_OBSERVATION_SIZE]
+ *   actions       int32_t[num_arenas], each in [0, WBZ_ENV_ACTION_COUNT)
+ *   rewards       float[num_arenas]
+ *   dones         uint8_t[num_arenas]
+ * Functions returning int return 0 on success and -1 on failure, with the
+ * reason in wbz_env_last_error(). */
+#ifndef WBZ_ENV_H
+#define WBZ_ENV_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WBZ_ENV_OBSERVATION_SIZE 12
+#define WBZ_ENV_ACTION_COUNT 10
+
+typedef struct wbz_env wbz_env;
+
+typedef struct {
+  uint32_t num_arenas;
+  /* 1 steps on the calling thread, 0 uses every core. */
+  uint32_t num_threads;
+  /* Simulation ticks per step; 0 means 4. */
+  uint32_t frame_skip;
+  /* Ticks before an episode is cut off; 0 means no limit. */
+  uint32_t max_episode_ticks;
+  /* Simulation rate; 0 means 120. */
+  uint32_t tick_rate;
+  uint64_t seed;
+} wbz_env_config;
+
+typedef struct {
+  uint64_t steps;
+  uint64_t episodes;
+  uint64_t ticks;
+  /* Milliseconds inside wbz_env_step, simulating and packing results. */
+  double simulate_ms;
+  double marshal_ms;
+} wbz_env_stats;
+
+wbz_env *wbz_env_create(const wbz_env_config *config);
+void wbz_env_destroy(wbz_env *env);
+
+uint32_t wbz_env_num_arenas(const wbz_env *env);
+
+/* Resets every arena and writes their first observations. */
+int wbz_env_reset(wbz_env *env, float *observations);
+
+/* Steps every arena with its action. Arenas whose episode ended report
+ * done and are reset, and their observation is the first of the next
+ * episode. */
+int wbz_env_step(wbz_env *env, const int32_t *actions, float *observations,
+                 float *rewards, uint8_t *dones);
+
+void wbz_env_get_stats(const wbz_env *env, wbz_env_stats *stats);
+
+const char *wbz_env_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/* Shared-memory protocol of the environment server (`make env_server`).
+ *
+ * Each environment is one POSIX shared memory object, named
+ * "/wbz_env_<name>_<index>", laid out as a wbz_shm_header followed by
+ * slot_count request slots and slot_count response slots. Requests and
+ * responses are single-producer single-consumer rings: the producer fills
+ * slot[head % slot_count] and then increments head, the consumer reads
+ * slot[tail % slot_count] and then increments tail. Head and tail are
+ * free-running and must be accessed atomically (acquire loads, release
+ * stores). They double as futex words: after changing one, check the
+ * matching *_waiters word and FUTEX_WAKE the index if it was set. A
+ * waiter sets *_waiters to 1, re-checks the index, then FUTEX_WAITs on it.
+ *
+ * Request slot:  uint32_t command; uint32_t reserved;
+ *                int32_t actions[num_arenas];
+ * Response slot: uint32_t status; uint32_t reserved;
+ *                float observations[num_arenas * observation_size];
+ *                float rewards[num_arenas];
+ *                uint8_t dones[num_arenas];
+ * Slots are padded to a multiple of 64 bytes. A client drives its
+ * environment in lockstep: one request, then wait for its response. */
+#ifndef WBZ_ENV_SHM_H
+#define WBZ_ENV_SHM_H
+
+#include <stdint.h>
+
+#define WBZ_SHM_MAGIC 0x4d48535au /* "ZSHM" */
+#define WBZ_SHM_VERSION 1u
+
+enum {
+  WBZ_SHM_RESET = 1,
+  WBZ_SHM_STEP = 2,
+  /* Ends the session; the server answers, then stops serving. */
+  WBZ_SHM_CLOSE = 3,
+};
+
+enum {
+  WBZ_SHM_STARTING = 0,
+  WBZ_SHM_READY = 1,
+  WBZ_SHM_CLOSED = 2,
+};
+
+enum {
+  WBZ_SHM_OK = 0,
+  WBZ_SHM_ERROR = 1,
+};
+
+/* Every index and waiter word sits on its own 64-byte line. */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_arenas;
+  uint32_t observation_size;
+  uint32_t slot_count;
+  uint32_t request_slot_size;
+  uint32_t response_slot_size;
+  uint32_t state;
+  uint32_t reserved[8];
+
+  uint32_t request_head; /* written by the client */
+  uint32_t request_head_waiters;
+  uint32_t pad0[14];
+  uint32_t request_tail; /* written by the server */
+  uint32_t request_tail_waiters;
+  uint32_t pad1[14];
+  uint32_t response_head; /* written by the server */
+  uint32_t response_head_waiters;
+  uint32_t pad2[14];
+  uint32_t response_tail; /* written by the client */
+  uint32_t response_tail_waiters;
+  uint32_t pad3[14];
+} wbz_shm_header;
+
+#endif
@@ -4,7 +4,7 @@
 
 int main(int argc, char *argv[]) {
   try {
-    wbz::Application::run();
+    wbz::Application::run(argc, argv);
   } catch (...) {
     wbz::Application::shutdown();
     std::cerr << "Application shutdown with an exception\n";
@@ -0,0 +1,237 @@
+#include "asset_loader.hpp"
+#include "text/bitmap_font.hpp"
+#include "text/text_renderer.hpp"
+#include <SDL2/SDL_image.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace wbz {
+namespace managers {
+
+void AssetLoader::start(size_t worker_count) {
+  // Initialize the image codecs up front so workers do not race on the lazy
+  // initialization inside IMG_Load.
+  IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+  _pool.start(worker_count);
+  ResourceManager::set_texture_loader([this](const std::string &key) {
+    load_texture(key, ResourceManager::PathPolicy::ABSOLUTE);
+  });
+}
+
+void AssetLoader::shutdown() {
+  ResourceManager::set_texture_loader(nullptr);
+
+  // Stopping the pool finishes the queued worker jobs, so everything they
+  // post is in _main_thread_jobs afterwards.
+  _pool.stop();
+
+  std::deque<MainThreadJob> jobs;
+  {
+    std::lock_guard<std::mutex> lock(_main_thread_mutex);
+    jobs.swap(_main_thread_jobs);
+  }
+  for (auto &job : jobs) {
+    if (job.cancel) {
+      job.cancel();
+    }
+  }
+}
+
+void AssetLoader::post_to_main_thread(std::function<void(SDL_Renderer *)> run,
+                                      std::function<void()> cancel) {
+  std::lock_guard<std::mutex> lock(_main_thread_mutex);
+  _main_thread_jobs.push_back({std::move(run), std::move(cancel)});
+}
+
+AssetLoader::TextureFuture
+AssetLoader::load_texture(const fs::path &file_path,
+                          ResourceManager::PathPolicy policy) {
+  std::string key = ResourceManager::texture_path(file_path, policy).string();
+
+  auto promise = std::make_shared<std::promise<std::shared_ptr<SDL_Texture>>>();
+  TextureFuture future = promise->get_future().share();
+
+  if (auto texture = ResourceManager::find_texture(key)) {
+    promise->set_value(texture);
+    return future;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    auto pending = _pending_textures.find(key);
+    if (pending != _pending_textures.end()) {
+      return pending->second;
+    }
+    _pending_textures.emplace(key, future);
+  }
+
+  ResourceManager::mark_texture_pending(key);
+  ++_requested;
+
+  _pool.enqueue([this, key, promise] {
+    SDL_Surface *surface = IMG_Load(key.c_str());
+    std::string error = surface ? "" : IMG_GetError();
+
+    // Convert on the worker so the upload does not have to.
+    if (surface) {
+      SDL_Surface *converted =
+          SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+      if (converted) {
+        SDL_FreeSurface(surface);
+        surface = converted;
+      }
+    }
+
+    post_to_main_thread(
+        [this, key, promise, surface, error](SDL_Renderer *renderer) {
+          SDL_Texture *texture =
+              surface ? SDL_CreateTextureFromSurface(renderer, surface)
+                      : nullptr;
+          if (surface) {
+            SDL_FreeSurface(surface);
+          }
+
+          if (texture) {
+            promise->set_value(ResourceManager::add_texture(key, texture));
+          } else {
+            std::cerr << "Failed to stream texture " << key << "; Error: "
+                      << (surface ? SDL_GetError() : error) << "\n";
+            ResourceManager::fail_texture(key);
+            promise->set_exception(std::make_exception_ptr(
+                std::runtime_error("Failed to load texture: " + key)));
+          }
+          finish_texture(key);
+        },
+        [this, key, promise, surface] {
+          if (surface) {
+            SDL_FreeSurface(surface);
+          }
+          ResourceManager::cancel_texture_pending(key);
+          promise->set_exception(std::make_exception_ptr(
+              std::runtime_error("Texture load cancelled: " + key)));
+          finish_texture(key);
+        });
+  });
+
+  return future;
+}
+
+void AssetLoader::finish_texture(const std::string &key) {
+  {
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    _pending_textures.erase(key);
+  }
+  ++_completed;
+}
+
+AssetLoader::AnimationSetFuture
+AssetLoader::load_animation_set(const fs::path &file_path) {
+  std::string key = ResourceManager::animation_path(file_path).string();
+
+  auto promise =
+      std::make_shared<std::promise<std::shared_ptr<const AnimationSet>>>();
+  AnimationSetFuture future = promise->get_future().share();
+  ++_requested;
+
+  _pool.enqueue([this, key, promise] {
+    std::shared_ptr<const AnimationSet> set;
+    try {
+      set = AnimationSet::load(key);
+      promise->set_value(set);
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+
+    post_to_main_thread([this, key, set](SDL_Renderer *) {
+      if (set) {
+        ResourceManager::add_animation_set(key, set);
+      }
+      ++_completed;
+    });
+  });
+
+  return future;
+}
+
+AssetLoader::FontFuture AssetLoader::load_font(const fs::path &file_path,
+                                               const std::vector<int> &sizes) {
+  std::string path = utils::R::fonts() + file_path.string();
+
+  auto promise = std::make_shared<std::promise<bool>>();
+  FontFuture future = promise->get_future().share();
+  ++_requested;
+
+  _pool.enqueue([this, path, sizes, promise] {
+    std::ifstream file(path, std::ios::binary);
+
+#ifdef WBZ_BITMAP_FONT
+    std::shared_ptr<const BitmapFont> font;
+    try {
+      font = BitmapFont::parse(std::string(std::istreambuf_iterator<char>(file),
+                                           std::istreambuf_iterator<char>()));
+    } catch (const std::exception &e) {
+      std::cerr << "Failed to parse " << path << ": " << e.what() << "\n";
+    }
+
+    post_to_main_thread(
+        [this, promise, font](SDL_Renderer *) {
+          if (font) {
+            TextRenderer::instance().set_bitmap_font(font);
+            load_texture(fs::path(utils::R::fonts()) /
+                             TextRenderer::atlas_path(*font),
+                         ResourceManager::PathPolicy::ABSOLUTE);
+          }
+          promise->set_value(font != nullptr);
+          ++_completed;
+        },
+        [promise] { promise->set_value(false); });
+#else
+    auto data = std::make_shared<std::vector<uint8_t>>(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    post_to_main_thread(
+        [this, path, sizes, promise, data](SDL_Renderer *) {
+          bool loaded = !data->empty();
+          for (int size : sizes) {
+            loaded = loaded && TextRenderer::instance().add_font(size, data);
+          }
+
+          if (!loaded) {
+            std::cerr << "Failed to load font: " << path << "\n";
+          }
+          promise->set_value(loaded);
+          ++_completed;
+        },
+        [promise] { promise->set_value(false); });
+#endif
+  });
+
+  return future;
+}
+
+void AssetLoader::pump(SDL_Renderer *renderer, double budget_ms) {
+  const Uint64 start = SDL_GetPerformanceCounter();
+  const double ticks_per_ms = SDL_GetPerformanceFrequency() / 1000.0;
+
+  for (;;) {
+    MainThreadJob job;
+    {
+      std::lock_guard<std::mutex> lock(_main_thread_mutex);
+      if (_main_thread_jobs.empty())
+        return;
+
+      job = std::move(_main_thread_jobs.front());
+      _main_thread_jobs.pop_front();
+    }
+
+    job.run(renderer);
+
+    if ((SDL_GetPerformanceCounter() - start) / ticks_per_ms >= budget_ms)
+      return;
+  }
+}
+
+} // namespace managers
+} // namespace wbz
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <SDL_render.h>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <managers/resource_manager/resource_manager.hpp>
+#include <memory>
+#include <mutex>
+#include <sprite/animator/animation_set.hpp>
+#include <string>
+#include <unordered_map>
+#include <utils/thread_pool.hpp>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace wbz {
+namespace managers {
+
+// Streams assets in without stalling the render path: images are decoded,
+// animation XML parsed and font files read on a worker pool, while the work
+// that must happen on the render thread (texture uploads, opening fonts,
+// publishing into the ResourceManager caches) is queued and drained by
+// pump() under a per-frame time budget.
+class AssetLoader {
+public:
+  using TextureFuture = std::shared_future<std::shared_ptr<SDL_Texture>>;
+  using AnimationSetFuture =
+      std::shared_future<std::shared_ptr<const AnimationSet>>;
+  using FontFuture = std::shared_future<bool>;
+
+  static AssetLoader &instance() {
+    static AssetLoader instance;
+    return instance;
+  }
+
+  void start(size_t worker_count = 0);
+  void shutdown();
+
+  TextureFuture load_texture(const fs::path &file_path,
+                             ResourceManager::PathPolicy policy =
+                                 ResourceManager::PathPolicy::RELATIVE);
+  AnimationSetFuture load_animation_set(const fs::path &file_path);
+  FontFuture load_font(const fs::path &file_path,
+                       const std::vector<int> &sizes);
+
+  // Runs queued main-thread work until the budget is spent. At least one job
+  // runs per call so loading always makes progress.
+  void pump(SDL_Renderer *renderer, double budget_ms);
+
+  size_t requested() const { return _requested; }
+  size_t completed() const { return _completed; }
+  float progress() const {
+    size_t requested = _requested;
+    return requested == 0 ? 1.0f
+                          : static_cast<float>(_completed) /
+                                static_cast<float>(requested);
+  }
+  bool is_idle() const { return _completed == _requested; }
+
+private:
+  AssetLoader() = default;
+  ~AssetLoader() { shutdown(); }
+
+  AssetLoader(const AssetLoader &) = delete;
+  AssetLoader &operator=(const AssetLoader &) = delete;
+
+  // Work for the render thread. Jobs still queued at shutdown are cancelled
+  // instead, which must release what run would have consumed.
+  struct MainThreadJob {
+    std::function<void(SDL_Renderer *)> run;
+    std::function<void()> cancel;
+  };
+
+  utils::ThreadPool _pool;
+  std::deque<MainThreadJob> _main_thread_jobs;
+  std::mutex _main_thread_mutex;
+
+  // Textures being streamed in, so a second request joins the first.
+  std::unordered_map<std::string, TextureFuture> _pending_textures;
+  std::mutex _pending_mutex;
+
+  std::atomic<size_t> _requested{0};
+  std::atomic<size_t> _completed{0};
+
+  void post_to_main_thread(std::function<void(SDL_Renderer *)> run,
+                           std::function<void()> cancel = nullptr);
+  void finish_texture(const std::string &key);
+};
+
+} // namespace managers
+} // namespace wbz
@@ -2,8 +2,10 @@
 #include "entities/character/ai_character.hpp"
 #include "utils/r.hpp"
 #include <SDL_keycode.h>
+#include <SDL_timer.h>
 #include <entities/character/character.hpp>
 #include <iostream>
+#include <managers/asset_loader/asset_loader.hpp>
 #include <managers/input_manager/input_manager.hpp>
 #include <memory>
 
@@ -11,17 +13,23 @@ namespace wbz {
 namespace managers {
 
 void GameManager::init() {
+  auto &loader = AssetLoader::instance();
+  auto player_animations = loader.load_animation_set("janemba.xml");
+  auto computer_animations = loader.load_animation_set("goku_ssjb.xml");
 
   Sprite player_sprite("janemba.png", {64, 1271, 64, 64}, {0, 0, 64, 64});
 
   entities::CombatStats player_stats(120, 100, 500.0f, 800.0f, 1.0f, 10, 1.1f);
 
-  auto player =
-      std::make_shared<entities::Character>(player_sprite, player_stats);
+  // In AI-vs-AI mode a second learning agent takes the player's place.
+  std::shared_ptr<entities::Character> player =
+      _ai_vs_ai
+          ? std::make_shared<entities::AICharacter>(player_sprite, player_stats)
+          : std::make_shared<entities::Character>(player_sprite, player_stats);
 
   try {
-    player->animator().load_animations(utils::R::animations() + "janemba.xml");
-    player->animator().play("Idle");
+    player->set_animations(player_animations.get());
+    player->play_animation(entities::CharacterAnimation::IDLE);
   } catch (const std::exception &e) {
     std::cerr << "Error loading player animations: " << e.what() << std::endl;
   }
@@ -35,12 +43,15 @@ void GameManager::init() {
 
   auto computer =
       std::make_shared<entities::AICharacter>(computer_sprite, cpu_stats);
-  computer->animator().load_animations(utils::R::animations() +
-                                       "goku_ssjb.xml");
-  computer->animator().play("Idle");
+  computer->set_animations(computer_animations.get());
+  computer->play_animation(entities::CharacterAnimation::IDLE);
   computer->mover().set_position(Vector2f(740.0f, 400.0f));
 
   computer->set_opponent(player.get());
+  if (auto ai_player =
+          std::dynamic_pointer_cast<entities::AICharacter>(player)) {
+    ai_player->set_opponent(computer.get());
+  }
 
   _game_state.entities.push_back(computer);
 
@@ -50,21 +61,77 @@ void GameManager::init() {
   _game_state.map.set_map_rect({0, 3 * (1805 / 6), 1200, 1805 / 6});
 }
 
+void GameManager::set_trajectory_writer(ai::TrajectoryWriter *writer) {
+  // One writer holds one agent's episodes, so only the computer records.
+  if (auto computer = std::dynamic_pointer_cast<entities::AICharacter>(
+          _game_state.entities[1])) {
+    computer->set_trajectory_writer(writer);
+  }
+}
+
+void GameManager::set_decision_schedule(uint32_t interval, uint32_t budget) {
+  _decisions = ai::DecisionScheduler(interval, budget);
+  for (auto &entity : _game_state.entities) {
+    if (auto ai_character =
+            std::dynamic_pointer_cast<entities::AICharacter>(entity)) {
+      ai_character->set_decision_scheduler(&_decisions);
+    }
+  }
+}
+
+void GameManager::load_q_table(const std::string &path) {
+  for (auto &entity : _game_state.entities) {
+    if (auto ai_character =
+            std::dynamic_pointer_cast<entities::AICharacter>(entity)) {
+      ai_character->load_q_table(path);
+    }
+  }
+}
+
+void GameManager::enable_planning() {
+  for (auto &entity : _game_state.entities) {
+    if (auto ai_character =
+            std::dynamic_pointer_cast<entities::AICharacter>(entity)) {
+      ai_character->enable_planning();
+    }
+  }
+}
+
+uint32_t GameManager::plan(std::chrono::steady_clock::time_point deadline) {
+  uint32_t updates = 0;
+  for (auto &entity : _game_state.entities) {
+    if (auto ai_character =
+            std::dynamic_pointer_cast<entities::AICharacter>(entity)) {
+      updates += ai_character->plan(deadline);
+    }
+  }
+  return updates;
+}
+
 void GameManager::update(float delta_time) {
+  // Entities have updated for this tick; the budget is for the next one.
+  _decisions.begin_tick();
+
   auto player = _game_state.player_character;
-  if (!player || !player->state().is_alive()) {
-    if (auto ai_opponent = std::dynamic_pointer_cast<entities::AICharacter>(
-            _game_state.entities[1])) {
-      _game_state.reset_episode(); // This resets episode state
-      ai_opponent
-          ->start_new_episode(); // This triggers the AI's episode handling
+  auto computer =
+      std::dynamic_pointer_cast<entities::Character>(_game_state.entities[1]);
+  if (!player || !player->state().is_alive() ||
+      (_ai_vs_ai && !computer->state().is_alive())) {
+    _game_state.reset_episode(); // This resets episode state
+    for (auto &entity : _game_state.entities) {
+      if (auto ai_character =
+              std::dynamic_pointer_cast<entities::AICharacter>(entity)) {
+        ai_character->start_new_episode(); // The AI's episode handling
+      }
     }
     return;
   }
 
-  if (!player->is_stunned() && !player->is_in_recovery()) {
+  if (_ai_vs_ai) {
+    resolve_ai_attacks(*player, *computer);
+  } else if (!player->is_stunned() && !player->is_in_recovery()) {
     handle_movement_input(player);
-    handle_combat_input(player);
+    handle_combat_input(player, computer);
   }
 
   _game_state.update_round(delta_time);
@@ -74,144 +141,96 @@ void GameManager::update(float delta_time) {
   }
 }
 
+// Both fighters are agents: attacks started this tick land by range, as in
+// the training arenas.
+void GameManager::resolve_ai_attacks(entities::Character &player,
+                                     entities::Character &computer) {
+  if (player.attacks_started() != _player_attacks) {
+    entities::resolve_attack(player, computer);
+  }
+  if (computer.attacks_started() != _computer_attacks) {
+    entities::resolve_attack(computer, player);
+  }
+  _player_attacks = player.attacks_started();
+  _computer_attacks = computer.attacks_started();
+}
+
 void GameManager::handle_movement_input(
     std::shared_ptr<entities::Character> player) {
 
   Vector2f movement_force = Vector2f::zero();
   bool is_moving = false;
 
-  if (InputManager::is_key_down(SDLK_LEFT) ||
-      InputManager::is_key_pressed(SDLK_LEFT)) {
+  if (InputManager::is_action_down(InputAction::MOVE_LEFT)) {
     movement_force = movement_force.add(Vector2f(-5000.0f, 0.0f));
     is_moving = true;
   }
-  if (InputManager::is_key_down(SDLK_RIGHT) ||
-      InputManager::is_key_pressed(SDLK_RIGHT)) {
+  if (InputManager::is_action_down(InputAction::MOVE_RIGHT)) {
     movement_force = movement_force.add(Vector2f(5000.0f, 0.0f));
     is_moving = true;
   }
-  if (InputManager::is_key_down(SDLK_UP) ||
-      InputManager::is_key_pressed(SDLK_UP)) {
+  if (InputManager::is_action_down(InputAction::MOVE_UP)) {
     movement_force = movement_force.add(Vector2f(0.0f, -5000.0f));
     is_moving = true;
   }
-  if (InputManager::is_key_down(SDLK_DOWN) ||
-      InputManager::is_key_pressed(SDLK_DOWN)) {
+  if (InputManager::is_action_down(InputAction::MOVE_DOWN)) {
     movement_force = movement_force.add(Vector2f(0.0f, 5000.0f));
     is_moving = true;
   }
 
   if (is_moving) {
     player->mover().add_force(movement_force);
-    player->animator().play(movement_force.y < 0   ? "Up"
-                            : movement_force.y > 0 ? "Down"
-                            : movement_force.x < 0 ? "Left"
-                                                   : "Right");
+    player->play_animation(movement_force.y < 0
+                               ? entities::CharacterAnimation::UP
+                           : movement_force.y > 0
+                               ? entities::CharacterAnimation::DOWN
+                           : movement_force.x < 0
+                               ? entities::CharacterAnimation::LEFT
+                               : entities::CharacterAnimation::RIGHT);
   } else {
-    player->animator().play("Idle");
+    player->play_animation(entities::CharacterAnimation::IDLE);
   }
 }
 
 void GameManager::handle_combat_input(
-    std::shared_ptr<entities::Character> player) {
-
-  if (InputManager::is_key_pressed(SDLK_z)) {
-    if (player->perform_attack("light_punch")) {
-      check_hit_detection(player);
-    }
-  }
-  if (InputManager::is_key_pressed(SDLK_x)) {
-    if (player->perform_attack("heavy_punch")) {
-      check_hit_detection(player);
-    }
-  }
-  if (InputManager::is_key_pressed(SDLK_c)) {
-    if (player->perform_attack("light_kick")) {
-      check_hit_detection(player);
-    }
-  }
-  if (InputManager::is_key_pressed(SDLK_v)) {
-    if (player->perform_attack("heavy_kick")) {
-      check_hit_detection(player);
+    std::shared_ptr<entities::Character> player,
+    std::shared_ptr<entities::Character> opponent) {
+
+  struct AttackBinding {
+    InputAction action;
+    const char *attack;
+  };
+  static constexpr AttackBinding ATTACKS[] = {
+      {InputAction::LIGHT_PUNCH, "light_punch"},
+      {InputAction::HEAVY_PUNCH, "heavy_punch"},
+      {InputAction::LIGHT_KICK, "light_kick"},
+      {InputAction::HEAVY_KICK, "heavy_kick"},
+  };
+
+  // Presses wait in the buffer until the current attack reaches its cancel
+  // window or recovers, or until they are too old to count.
+  if (player->can_attack()) {
+    auto &buffer = InputManager::buffer();
+    const uint64_t tick = InputManager::tick();
+    for (const auto &binding : ATTACKS) {
+      auto *press = buffer.find(binding.action, tick, _input_buffer_ticks);
+      if (press && player->perform_attack(binding.attack)) {
+        buffer.consume(*press, tick, SDL_GetTicks());
+        if (opponent) {
+          entities::resolve_attack(*player, *opponent);
+        }
+        break;
+      }
     }
   }
 
-  if (InputManager::is_key_down(SDLK_SPACE)) {
+  if (InputManager::is_action_down(InputAction::BLOCK)) {
     player->set_combat_state(entities::CombatState::BLOCKING);
-  } else if (InputManager::is_key_released(SDLK_SPACE)) {
+  } else if (InputManager::is_action_released(InputAction::BLOCK)) {
     player->set_combat_state(entities::CombatState::IDLE);
   }
 }
 
-void GameManager::check_hit_detection(
-    std::shared_ptr<entities::Character> attacker) {
-
-  for (auto &entity : _game_state.entities) {
-    auto defender = std::dynamic_pointer_cast<entities::Character>(entity);
-    if (defender && defender != attacker) {
-
-      if (auto ai_defender =
-              std::dynamic_pointer_cast<entities::AICharacter>(defender)) {
-        ai_defender->on_got_hit();
-      }
-      if (auto ai_attacker =
-              std::dynamic_pointer_cast<entities::AICharacter>(attacker)) {
-        ai_attacker->on_hit_landed();
-      }
-      break;
-    }
-  }
-}
-
-void GameManager::update_cpu_behavior(
-    std::shared_ptr<entities::Character> cpu,
-    std::shared_ptr<entities::Character> player) {
-
-  if (!cpu || !player) {
-    return;
-  }
-
-  Vector2f to_player = player->mover().position().sub(cpu->mover().position());
-  float distance = to_player.mag();
-
-  if (std::isnan(distance) || distance < 0.0001f) {
-    return;
-  }
-
-  Vector2f direction = to_player.normalized();
-  if (std::isnan(direction.x) || std::isnan(direction.y)) {
-    direction = Vector2f(1.0f, 0.0f);
-  }
-
-  if (distance > 200.0f) {
-    Vector2f approach_force = direction.mul(3000.0f);
-    cpu->mover().add_force(approach_force);
-  } else if (distance < 100.0f) {
-    Vector2f retreat_force = direction.mul(-2000.0f);
-    cpu->mover().add_force(retreat_force);
-  }
-
-  const float MIN_ATTACK_DISTANCE = 20.0f;
-  if (distance > MIN_ATTACK_DISTANCE && distance < 150.0f &&
-      std::rand() % 100 < 5) {
-
-    switch (std::rand() % 4) {
-    case 0:
-      cpu->perform_attack("light_punch");
-      break;
-    case 1:
-      cpu->perform_attack("heavy_punch");
-      break;
-    case 2:
-      cpu->perform_attack("light_kick");
-      break;
-    case 3:
-      cpu->perform_attack("heavy_kick");
-      break;
-    }
-  }
-}
-
 void GameManager::cleanup() {
   _game_state.entities.clear();
   _game_state.player_character = nullptr;
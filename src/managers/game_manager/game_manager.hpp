@@ -1,27 +1,59 @@
 #pragma once
 
+#include <chrono>
+#include <entities/agent/decision_scheduler.hpp>
 #include <entities/character/character.hpp>
 #include <memory>
 #include <state/game_state.hpp>
+#include <string>
 
 namespace wbz {
+namespace ai {
+class TrajectoryWriter;
+}
+
 namespace managers {
 class GameManager {
 public:
   explicit GameManager(GameState &game_state) : _game_state(game_state) {}
 
+  // Must be set before init(): the player character is played by a second
+  // learning agent instead of the keyboard.
+  void set_ai_vs_ai(bool enabled) { _ai_vs_ai = enabled; }
+
   void init();
   void update(float delta_time);
   void cleanup();
 
+  // How many ticks an attack press may wait in the input buffer for the
+  // player to be able to act.
+  void set_input_buffer_ticks(uint64_t ticks) { _input_buffer_ticks = ticks; }
+  // Records the AI characters' transitions into the writer.
+  void set_trajectory_writer(ai::TrajectoryWriter *writer);
+  // AI characters decide every `interval` ticks, with at most `budget`
+  // decisions per tick (0 for no limit).
+  void set_decision_schedule(uint32_t interval, uint32_t budget);
+  const ai::DecisionScheduler &decisions() const { return _decisions; }
+  void load_q_table(const std::string &path);
+
+  // Lets the AI characters plan from their learned models until the
+  // deadline; returns the planning updates run.
+  void enable_planning();
+  uint32_t plan(std::chrono::steady_clock::time_point deadline);
+
 private:
   GameState &_game_state;
+  uint64_t _input_buffer_ticks = 12;
+  ai::DecisionScheduler _decisions;
+  bool _ai_vs_ai = false;
+  uint32_t _player_attacks = 0;
+  uint32_t _computer_attacks = 0;
 
   void handle_movement_input(std::shared_ptr<entities::Character> player);
-  void handle_combat_input(std::shared_ptr<entities::Character> player);
-  void update_cpu_behavior(std::shared_ptr<entities::Character> cpu,
-                           std::shared_ptr<entities::Character> player);
-  void check_hit_detection(std::shared_ptr<entities::Character> attacker);
+  void handle_combat_input(std::shared_ptr<entities::Character> player,
+                           std::shared_ptr<entities::Character> opponent);
+  void resolve_ai_attacks(entities::Character &player,
+                          entities::Character &computer);
 };
 } // namespace managers
 } // namespace wbz
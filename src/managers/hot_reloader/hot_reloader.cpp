@@ -0,0 +1,171 @@
+#include "hot_reloader.hpp"
+#include "managers/resource_manager/resource_manager.hpp"
+#include "utils/r.hpp"
+#include <SDL2/SDL_image.h>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <utility>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define WBZ_HOT_RELOAD_INOTIFY
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace wbz {
+namespace managers {
+
+void HotReloader::start() {
+#ifdef WBZ_HOT_RELOAD_INOTIFY
+  if (_running)
+    return;
+
+  _inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_inotify_fd < 0) {
+    std::cerr << "Hot reload disabled: inotify_init1 failed\n";
+    return;
+  }
+
+  const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+  _textures_watch =
+      inotify_add_watch(_inotify_fd, utils::R::textures().c_str(), mask);
+  _animations_watch =
+      inotify_add_watch(_inotify_fd, utils::R::animations().c_str(), mask);
+
+  _running = true;
+  _watcher = std::thread([this] { watch_loop(); });
+  std::cout << "Hot reload watching " << utils::R::textures() << " and "
+            << utils::R::animations() << "\n";
+#endif
+}
+
+void HotReloader::stop() {
+  _running = false;
+  if (_watcher.joinable()) {
+    _watcher.join();
+  }
+
+#ifdef WBZ_HOT_RELOAD_INOTIFY
+  if (_inotify_fd >= 0) {
+    close(_inotify_fd);
+    _inotify_fd = -1;
+  }
+#endif
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (auto &texture : _textures) {
+    SDL_FreeSurface(texture.surface);
+  }
+  _textures.clear();
+  _animation_sets.clear();
+}
+
+void HotReloader::watch_loop() {
+#ifdef WBZ_HOT_RELOAD_INOTIFY
+  alignas(struct inotify_event) char buffer[4096];
+
+  while (_running) {
+    pollfd fd{_inotify_fd, POLLIN, 0};
+    if (poll(&fd, 1, 200) <= 0)
+      continue;
+
+    // Editors tend to write a file several times in a row; collect the burst
+    // and reload each file once.
+    std::set<std::pair<int, std::string>> changed;
+    for (int burst = 0; burst < 2; ++burst) {
+      ssize_t length;
+      while ((length = read(_inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + length;) {
+          auto *event = reinterpret_cast<struct inotify_event *>(ptr);
+          if (event->len > 0) {
+            changed.emplace(event->wd, event->name);
+          }
+          ptr += sizeof(struct inotify_event) + event->len;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+
+    for (const auto &[watch, file_name] : changed) {
+      reload(watch, file_name);
+    }
+  }
+#endif
+}
+
+void HotReloader::reload(int watch, const std::string &file_name) {
+  if (watch == _textures_watch) {
+    std::string key = utils::R::textures() + file_name;
+    SDL_Surface *surface = IMG_Load(key.c_str());
+    if (!surface) {
+      std::cerr << "Hot reload failed for " << key << ": " << IMG_GetError()
+                << "\n";
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _textures.push_back({key, surface});
+  } else if (watch == _animations_watch) {
+    std::string key = utils::R::animations() + file_name;
+    try {
+      auto set = AnimationSet::load(key);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _animation_sets.push_back({key, std::move(set)});
+    } catch (const std::exception &e) {
+      std::cerr << "Hot reload failed for " << key << ": " << e.what() << "\n";
+    }
+  }
+}
+
+void HotReloader::apply_textures(SDL_Renderer *renderer) {
+  std::vector<ReloadedTexture> textures;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_textures.empty())
+      return;
+
+    textures.swap(_textures);
+  }
+
+  for (auto &texture : textures) {
+    SDL_Texture *reloaded =
+        renderer ? SDL_CreateTextureFromSurface(renderer, texture.surface)
+                 : nullptr;
+    SDL_FreeSurface(texture.surface);
+
+    if (reloaded) {
+      ResourceManager::add_texture(texture.key, reloaded);
+      std::cout << "Hot reloaded texture: " << texture.key << "\n";
+    }
+  }
+}
+
+void HotReloader::apply_animations(GameState &game_state) {
+  std::vector<ReloadedAnimationSet> animation_sets;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_animation_sets.empty())
+      return;
+
+    animation_sets.swap(_animation_sets);
+  }
+
+  for (auto &reloaded : animation_sets) {
+    auto previous = ResourceManager::find_animation_set(reloaded.key);
+    ResourceManager::add_animation_set(reloaded.key, reloaded.set);
+
+    for (auto &entity : game_state.entities) {
+      auto character = std::dynamic_pointer_cast<entities::Character>(entity);
+      if (character && previous &&
+          character->animator().animations() == previous) {
+        character->set_animations(reloaded.set);
+      }
+    }
+    std::cout << "Hot reloaded animations: " << reloaded.key << "\n";
+  }
+}
+
+} // namespace managers
+} // namespace wbz
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL_render.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sprite/animator/animation_set.hpp>
+#include <state/game_state.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wbz {
+namespace managers {
+
+// Watches the texture and animation directories (inotify, Linux only) and
+// re-decodes changed files on its own thread. Textures are uploaded by
+// apply_textures() on the render thread; animation sets are swapped into every
+// Animator using the old set by apply_animations() on the simulation thread.
+class HotReloader {
+public:
+  static HotReloader &instance() {
+    static HotReloader instance;
+    return instance;
+  }
+
+  void start();
+  void stop();
+
+  void apply_textures(SDL_Renderer *renderer);
+  void apply_animations(GameState &game_state);
+
+private:
+  HotReloader() = default;
+  ~HotReloader() { stop(); }
+
+  HotReloader(const HotReloader &) = delete;
+  HotReloader &operator=(const HotReloader &) = delete;
+
+  struct ReloadedTexture {
+    std::string key;
+    SDL_Surface *surface;
+  };
+
+  struct ReloadedAnimationSet {
+    std::string key;
+    std::shared_ptr<const AnimationSet> set;
+  };
+
+  std::thread _watcher;
+  std::atomic<bool> _running{false};
+  int _inotify_fd = -1;
+  int _textures_watch = -1;
+  int _animations_watch = -1;
+
+  std::mutex _mutex;
+  std::vector<ReloadedTexture> _textures;
+  std::vector<ReloadedAnimationSet> _animation_sets;
+
+  void watch_loop();
+  void reload(int watch, const std::string &file_name);
+};
+
+} // namespace managers
+} // namespace wbz
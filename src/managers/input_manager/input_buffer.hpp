@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace wbz {
+
+enum class InputAction : uint8_t;
+
+namespace managers {
+
+struct InputLatencyStats {
+  uint64_t actions = 0;
+  uint64_t total_ticks = 0;
+  uint64_t max_ticks = 0;
+  // Only presses with an SDL timestamp count towards the millisecond stats.
+  uint64_t timed_actions = 0;
+  uint64_t total_ms = 0;
+  uint64_t max_ms = 0;
+
+  double average_ticks() const {
+    return actions ? static_cast<double>(total_ticks) / actions : 0.0;
+  }
+  double average_ms() const {
+    return timed_actions ? static_cast<double>(total_ms) / timed_actions
+                         : 0.0;
+  }
+};
+
+// The last few action presses of one player, each stamped with the tick the
+// key actually went down on. Gameplay takes presses out of the buffer
+// instead of polling the current tick, so a press made slightly early (while
+// an attack is still recovering) fires as soon as the character can act.
+class InputBuffer {
+public:
+  static constexpr size_t CAPACITY = 32;
+
+  struct Press {
+    InputAction action;
+    uint64_t tick;
+    // SDL timestamp in milliseconds, 0 for replayed input.
+    uint32_t timestamp;
+    bool consumed;
+  };
+
+  void push(InputAction action, uint64_t tick, uint32_t timestamp) {
+    _presses[_next] = {action, tick, timestamp, false};
+    _next = (_next + 1) % CAPACITY;
+    _count = std::min(_count + 1, CAPACITY);
+  }
+
+  // Oldest unconsumed press of the action made within the last window ticks.
+  Press *find(InputAction action, uint64_t now, uint64_t window) {
+    for (size_t i = 0; i < _count; ++i) {
+      Press &press = _presses[(_next + CAPACITY - _count + i) % CAPACITY];
+      if (!press.consumed && press.action == action &&
+          press.tick + window >= now) {
+        return &press;
+      }
+    }
+    return nullptr;
+  }
+
+  // Marks the press as acted upon at tick now, at SDL time now_ms.
+  void consume(Press &press, uint64_t now, uint32_t now_ms) {
+    press.consumed = true;
+
+    uint64_t ticks = now - std::min(now, press.tick);
+    _latency.actions++;
+    _latency.total_ticks += ticks;
+    _latency.max_ticks = std::max(_latency.max_ticks, ticks);
+
+    if (press.timestamp != 0 && now_ms >= press.timestamp) {
+      uint64_t ms = now_ms - press.timestamp;
+      _latency.timed_actions++;
+      _latency.total_ms += ms;
+      _latency.max_ms = std::max(_latency.max_ms, ms);
+    }
+  }
+
+  void clear() {
+    _next = 0;
+    _count = 0;
+  }
+
+  const InputLatencyStats &latency() const { return _latency; }
+
+private:
+  std::array<Press, CAPACITY> _presses{};
+  size_t _next = 0;
+  size_t _count = 0;
+  InputLatencyStats _latency;
+};
+
+} // namespace managers
+} // namespace wbz
@@ -0,0 +1,103 @@
+#include "input_log.hpp"
+#include "input_manager.hpp"
+#include <iostream>
+#include <stdexcept>
+
+namespace wbz {
+namespace managers {
+
+void InputRecorder::start(const std::string &path, uint16_t simulation_hz,
+                          uint64_t seed) {
+  _file.open(path, std::ios::binary | std::ios::trunc);
+  if (!_file) {
+    throw std::runtime_error("Failed to open input log: " + path);
+  }
+
+  InputLogHeader header;
+  header.simulation_hz = simulation_hz;
+  header.seed = seed;
+  _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  _events = 0;
+
+  std::cout << "Recording input to " << path << "\n";
+}
+
+void InputRecorder::record(uint64_t tick, const SDL_Event &event) {
+  if (!_file.is_open() ||
+      (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP)) {
+    return;
+  }
+
+  InputLogRecord record;
+  record.tick = static_cast<uint32_t>(tick);
+  record.scancode = static_cast<uint16_t>(event.key.keysym.scancode);
+  record.type = event.type == SDL_KEYDOWN ? InputLogRecord::KEY_DOWN
+                                          : InputLogRecord::KEY_UP;
+  record.repeat = event.key.repeat;
+  record.keycode = event.key.keysym.sym;
+  _file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+  ++_events;
+}
+
+void InputRecorder::stop(uint64_t tick) {
+  if (!_file.is_open()) {
+    return;
+  }
+
+  InputLogRecord end = {static_cast<uint32_t>(tick), 0, InputLogRecord::END,
+                        0, 0};
+  _file.write(reinterpret_cast<const char *>(&end), sizeof(end));
+  _file.close();
+
+  std::cout << "Recorded " << _events << " input events over " << tick
+            << " ticks\n";
+}
+
+void InputReplay::open(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open input log: " + path);
+  }
+
+  file.read(reinterpret_cast<char *>(&_header), sizeof(_header));
+  if (!file || _header.magic != InputLogHeader::MAGIC ||
+      _header.version != InputLogHeader::VERSION) {
+    throw std::runtime_error("Not an input log: " + path);
+  }
+
+  InputLogRecord record;
+  while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    if (record.type == InputLogRecord::END) {
+      _length = record.tick;
+      break;
+    }
+    _records.push_back(record);
+    _length = record.tick + 1;
+  }
+
+  _next = 0;
+  _opened = true;
+  std::cout << "Replaying " << _records.size() << " input events over "
+            << _length << " ticks from " << path << "\n";
+}
+
+bool InputReplay::feed(uint64_t tick) {
+  for (; _next < _records.size() && _records[_next].tick <= tick; ++_next) {
+    const InputLogRecord &record = _records[_next];
+
+    SDL_Event event{};
+    event.type = record.type == InputLogRecord::KEY_DOWN ? SDL_KEYDOWN
+                                                         : SDL_KEYUP;
+    event.key.state =
+        record.type == InputLogRecord::KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+    event.key.repeat = record.repeat;
+    event.key.keysym.scancode = static_cast<SDL_Scancode>(record.scancode);
+    event.key.keysym.sym = record.keycode;
+    InputManager::handle_events(event, record.tick);
+  }
+
+  return tick < _length;
+}
+
+} // namespace managers
+} // namespace wbz
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "SDL_events.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace wbz {
+namespace managers {
+
+// Compact binary log of keyboard input: a 16-byte header holding the
+// simulation rate and seed the session ran with, then one 12-byte record
+// per key event stamped with the simulation tick it was applied on. The
+// last record marks the tick recording stopped at.
+struct InputLogHeader {
+  static constexpr uint32_t MAGIC = 0x495a4257; // "WBZI"
+  static constexpr uint16_t VERSION = 1;
+
+  uint32_t magic = MAGIC;
+  uint16_t version = VERSION;
+  uint16_t simulation_hz = 0;
+  uint64_t seed = 0;
+};
+static_assert(sizeof(InputLogHeader) == 16, "InputLogHeader is padded");
+
+struct InputLogRecord {
+  enum Type : uint8_t { KEY_DOWN, KEY_UP, END };
+
+  uint32_t tick;
+  uint16_t scancode;
+  uint8_t type;
+  uint8_t repeat;
+  int32_t keycode;
+};
+static_assert(sizeof(InputLogRecord) == 12, "InputLogRecord is padded");
+
+class InputRecorder {
+public:
+  void start(const std::string &path, uint16_t simulation_hz, uint64_t seed);
+  void record(uint64_t tick, const SDL_Event &event);
+  void stop(uint64_t tick);
+
+  bool is_recording() const { return _file.is_open(); }
+
+private:
+  std::ofstream _file;
+  uint64_t _events = 0;
+};
+
+// Replays a log through InputManager::handle_events on the ticks the events
+// were recorded on.
+class InputReplay {
+public:
+  void open(const std::string &path);
+
+  bool is_open() const { return _opened; }
+  const InputLogHeader &header() const { return _header; }
+  uint64_t length() const { return _length; }
+
+  // Feeds every event recorded for `tick`; returns false once the recorded
+  // session is over.
+  bool feed(uint64_t tick);
+
+private:
+  bool _opened = false;
+  InputLogHeader _header;
+  std::vector<InputLogRecord> _records;
+  size_t _next = 0;
+  uint64_t _length = 0;
+};
+
+} // namespace managers
+} // namespace wbz
@@ -1,85 +1,145 @@
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <cstdint>
-#include <unordered_map>
 
 #include "SDL_events.h"
+#include "input_buffer.hpp"
 
 namespace wbz {
 
-enum class InputState {
-  NOT_PRESSED = 0,
-  PRESSED,
-  DOWN,
-  RELEASED,
+enum class InputAction : uint8_t {
+  MOVE_LEFT,
+  MOVE_RIGHT,
+  MOVE_UP,
+  MOVE_DOWN,
+  LIGHT_PUNCH,
+  HEAVY_PUNCH,
+  LIGHT_KICK,
+  HEAVY_KICK,
+  BLOCK,
+  COUNT
 };
 
 namespace managers {
+
+// Keyboard state as scancode-indexed bitsets. Events only flip bits in
+// _current; update() derives the pressed/released edges with a few bitwise
+// ops once per tick, so every query afterwards is a single bit test. Presses
+// of bound keys also go into the player's InputBuffer.
 class InputManager {
 public:
+  using KeySet = std::bitset<SDL_NUM_SCANCODES>;
+
   static InputManager &instance() {
     static InputManager instance;
     return instance;
   }
 
-  static void handle_events(const SDL_Event &event) {
-    if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) {
+  // `tick` is the simulation tick the event happened on, which can be
+  // earlier than the tick it is handled on.
+  static void handle_events(const SDL_Event &event, uint64_t tick) {
+    if ((event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) ||
+        event.key.repeat) {
       return;
     }
 
-    auto &app = instance();
-
-    if (event.type == SDL_KEYDOWN &&
-        app._key_states[event.key.keysym.sym] == InputState::PRESSED) {
-      app._key_states[event.key.keysym.sym] = InputState::DOWN;
-    } else if (event.type == SDL_KEYDOWN) {
-      app._key_states[event.key.keysym.sym] = InputState::PRESSED;
-    } else {
-      app._key_states[event.key.keysym.sym] = InputState::RELEASED;
+    size_t scancode = event.key.keysym.scancode;
+    if (scancode >= SDL_NUM_SCANCODES) {
+      return;
     }
-  }
 
-  static void update() {
     auto &app = instance();
-    for (auto &[key, state] : app._key_states) {
-      switch (state) {
-      case InputState::RELEASED:
-        state = InputState::NOT_PRESSED;
-      case InputState::PRESSED:
-      case InputState::DOWN:
-      case InputState::NOT_PRESSED:
-        break;
+    if (event.type == SDL_KEYDOWN) {
+      app._current.set(scancode);
+      if (app._actions[scancode] != InputAction::COUNT) {
+        app._buffer.push(app._actions[scancode], tick, event.key.timestamp);
       }
+    } else {
+      // Pressed and released between two ticks still counts as a press.
+      if (app._current.test(scancode) && !app._previous.test(scancode)) {
+        app._taps.set(scancode);
+      }
+      app._current.reset(scancode);
     }
   }
 
-  static bool is_key_pressed(uint16_t key) {
+  // Call once per tick, after the tick's events and before any query.
+  static void update(uint64_t tick) {
     auto &app = instance();
-    if (!app._key_states.count(key))
-      return false;
+    app._tick = tick;
+    app._pressed = (app._current & ~app._previous) | app._taps;
+    app._released = (app._previous & ~app._current) | app._taps;
+    app._previous = app._current;
+    app._taps.reset();
+  }
 
-    return app._key_states.at(key) == InputState::PRESSED;
+  static bool is_key_pressed(SDL_Scancode key) {
+    return instance()._pressed.test(key);
   }
 
-  static bool is_key_down(uint16_t key) {
-    auto &app = instance();
-    if (!app._key_states.count(key))
-      return false;
+  static bool is_key_down(SDL_Scancode key) {
+    return instance()._previous.test(key);
+  }
 
-    return app._key_states.at(key) == InputState::DOWN;
+  static bool is_key_released(SDL_Scancode key) {
+    return instance()._released.test(key);
   }
 
-  static bool is_key_released(uint16_t key) {
-    auto &app = instance();
-    if (!app._key_states.count(key))
-      return false;
+  static bool is_action_pressed(InputAction action) {
+    return is_key_pressed(binding(action));
+  }
+
+  static bool is_action_down(InputAction action) {
+    return is_key_down(binding(action));
+  }
 
-    return app._key_states.at(key) == InputState::RELEASED;
+  static bool is_action_released(InputAction action) {
+    return is_key_released(binding(action));
+  }
+
+  static uint64_t tick() { return instance()._tick; }
+  static InputBuffer &buffer() { return instance()._buffer; }
+
+  static SDL_Scancode binding(InputAction action) {
+    return instance()._bindings[static_cast<size_t>(action)];
+  }
+
+  static void bind(InputAction action, SDL_Scancode key) {
+    auto &app = instance();
+    app._bindings[static_cast<size_t>(action)] = key;
+    app.map_actions();
   }
 
 private:
-  InputManager() = default;
-  std::unordered_map<uint16_t, InputState> _key_states;
+  InputManager() { map_actions(); }
+
+  // Reverse of _bindings, so a key event finds its action in one load.
+  void map_actions() {
+    _actions.fill(InputAction::COUNT);
+    for (size_t i = 0; i < _bindings.size(); ++i) {
+      _actions[_bindings[i]] = static_cast<InputAction>(i);
+    }
+  }
+
+  // Physical key state as of the last event.
+  KeySet _current;
+  // State latched by the last update(), which is what queries see.
+  KeySet _previous;
+  KeySet _pressed;
+  KeySet _released;
+  KeySet _taps;
+
+  // Indexed by InputAction; physical keys, so layouts do not move them.
+  std::array<SDL_Scancode, static_cast<size_t>(InputAction::COUNT)>
+      _bindings{SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT, SDL_SCANCODE_UP,
+                SDL_SCANCODE_DOWN, SDL_SCANCODE_Z,     SDL_SCANCODE_X,
+                SDL_SCANCODE_C,    SDL_SCANCODE_V,     SDL_SCANCODE_SPACE};
+  std::array<InputAction, SDL_NUM_SCANCODES> _actions;
+
+  uint64_t _tick = 0;
+  InputBuffer _buffer;
 
   InputManager(const InputManager &) = delete;
   InputManager &operator=(const InputManager &) = delete;
@@ -4,11 +4,17 @@
 #include <SDL_render.h>
 #include <algorithm>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <sprite/animator/animation_set.hpp>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utils/log.hpp>
 #include <utils/r.hpp>
 
 namespace fs = std::filesystem;
@@ -16,6 +22,16 @@ namespace fs = std::filesystem;
 namespace wbz {
 namespace managers {
 
+struct TextureCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t bytes = 0;
+  size_t peak_bytes = 0;
+  size_t budget_bytes = 0;
+  size_t texture_count = 0;
+};
+
 class ResourceManager {
 public:
   enum class PathPolicy {
@@ -28,23 +44,40 @@ public:
     return instance;
   }
 
+  static fs::path texture_path(const fs::path &file_path,
+                               PathPolicy policy = PathPolicy::RELATIVE) {
+    return policy == PathPolicy::ABSOLUTE
+               ? file_path
+               : fs::path(utils::R::textures() + file_path.string());
+  }
+
+  static fs::path animation_path(const fs::path &file_path,
+                                 PathPolicy policy = PathPolicy::RELATIVE) {
+    return policy == PathPolicy::ABSOLUTE
+               ? file_path
+               : fs::path(utils::R::animations() + file_path.string());
+  }
+
+  // Returns nullptr while the texture is still being streamed in. A miss is
+  // handed to the registered loader (the AssetLoader) rather than decoded
+  // synchronously on the render path; without one, e.g. before the loader
+  // starts, the texture is loaded in place.
   static std::shared_ptr<SDL_Texture>
   get_texture(SDL_Renderer *renderer, const fs::path &file_path,
               PathPolicy policy = PathPolicy::RELATIVE) {
 
     auto &resource_manager = instance();
 
-    fs::path adjusted_file_path =
-        policy == PathPolicy::ABSOLUTE
-            ? file_path
-            : fs::path(utils::R::textures() + file_path.string());
-
-    auto found_texture =
-        resource_manager._textures.find(adjusted_file_path.string());
-    if (found_texture != resource_manager._textures.end()) {
-      /* std::cout << "Texture found in cache: " << adjusted_file_path << "\n";
-       */
-      return found_texture->second;
+    fs::path adjusted_file_path = texture_path(file_path, policy);
+    const std::string key = adjusted_file_path.string();
+
+    if (auto texture = find_texture(key)) {
+      return texture;
+    }
+
+    if (resource_manager._pending_textures.count(key) ||
+        resource_manager._failed_textures.count(key)) {
+      return nullptr;
     }
 
     if (!fs::exists(adjusted_file_path)) {
@@ -53,6 +86,13 @@ public:
       throw std::runtime_error("Failed to load texture: File not found");
     }
 
+    if (resource_manager._texture_loader) {
+      resource_manager._texture_loader(key);
+      return nullptr;
+    }
+
+    resource_manager._texture_stats.misses++;
+
     SDL_Surface *surface = IMG_Load(adjusted_file_path.c_str());
     if (surface == nullptr) {
       std::cerr << "Failed to load image at path: " << adjusted_file_path
@@ -70,28 +110,211 @@ public:
 
     SDL_FreeSurface(surface);
 
-    resource_manager._textures.emplace(
-        adjusted_file_path.string(),
-        std::shared_ptr<SDL_Texture>(texture, SDL_DestroyTexture));
+    return add_texture(key, texture);
+  }
+
+  // Called with the absolute path of every texture cache miss.
+  static void
+  set_texture_loader(std::function<void(const std::string &)> loader) {
+    instance()._texture_loader = std::move(loader);
+  }
+
+  // Starts a render frame. Textures drawn in this frame or the previous one
+  // are the working set and are never evicted, even though the draw calls
+  // hold them only briefly.
+  static void begin_frame() { instance()._frame++; }
+
+  static std::shared_ptr<const AnimationSet>
+  get_animation_set(const fs::path &file_path,
+                    PathPolicy policy = PathPolicy::RELATIVE) {
+
+    auto &resource_manager = instance();
+
+    fs::path adjusted_file_path = animation_path(file_path, policy);
+
+    std::lock_guard<std::mutex> lock(resource_manager._animation_sets_mutex);
+    auto found_set =
+        resource_manager._animation_sets.find(adjusted_file_path.string());
+    if (found_set != resource_manager._animation_sets.end()) {
+      return found_set->second;
+    }
+
+    auto set = AnimationSet::load(adjusted_file_path.string());
+    resource_manager._animation_sets.emplace(adjusted_file_path.string(), set);
+
+    return set;
+  }
+
+  static std::shared_ptr<SDL_Texture> find_texture(const std::string &key) {
+    auto &resource_manager = instance();
+    auto found_texture = resource_manager._textures.find(key);
+    if (found_texture == resource_manager._textures.end()) {
+      return nullptr;
+    }
+
+    resource_manager._texture_stats.hits++;
+    found_texture->second.used_frame = resource_manager._frame;
+    resource_manager._lru.splice(resource_manager._lru.begin(),
+                                 resource_manager._lru,
+                                 found_texture->second.lru);
+    return found_texture->second.texture;
+  }
+
+  static void mark_texture_pending(const std::string &key) {
+    auto &resource_manager = instance();
+    resource_manager._texture_stats.misses++;
+    resource_manager._pending_textures.insert(key);
+  }
+
+  static void cancel_texture_pending(const std::string &key) {
+    instance()._pending_textures.erase(key);
+  }
+
+  // A texture that failed to load is not requested again.
+  static void fail_texture(const std::string &key) {
+    auto &resource_manager = instance();
+    resource_manager._pending_textures.erase(key);
+    resource_manager._failed_textures.insert(key);
+  }
+
+  static std::shared_ptr<SDL_Texture> add_texture(const std::string &key,
+                                                  SDL_Texture *texture) {
+    auto &resource_manager = instance();
+    resource_manager._pending_textures.erase(key);
+    resource_manager.erase_texture(key);
+
+    Uint32 format = 0;
+    int width = 0, height = 0;
+    SDL_QueryTexture(texture, &format, nullptr, &width, &height);
+
+    TextureEntry entry;
+    entry.texture = std::shared_ptr<SDL_Texture>(texture, SDL_DestroyTexture);
+    entry.used_frame = resource_manager._frame;
+    entry.bytes = static_cast<size_t>(width) * static_cast<size_t>(height) *
+                  SDL_BYTESPERPIXEL(format);
+    resource_manager._lru.push_front(key);
+    entry.lru = resource_manager._lru.begin();
+
+    auto &stats = resource_manager._texture_stats;
+    stats.bytes += entry.bytes;
+    stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes);
+
+    auto result = entry.texture;
+    resource_manager._textures.emplace(key, std::move(entry));
+    stats.texture_count = resource_manager._textures.size();
+
+    resource_manager.enforce_texture_budget();
+    return result;
+  }
+
+  // Textures in the working set or still referenced outside the cache are
+  // never evicted, so the budget can be exceeded while everything is in use.
+  static void set_texture_budget(size_t bytes) {
+    auto &resource_manager = instance();
+    resource_manager._texture_stats.budget_bytes = bytes;
+    resource_manager.enforce_texture_budget();
+  }
+
+  static const TextureCacheStats &texture_stats() {
+    return instance()._texture_stats;
+  }
+
+  // Must run while the renderer owning the textures is still alive.
+  static void clear() {
+    auto &resource_manager = instance();
+    resource_manager._textures.clear();
+    resource_manager._lru.clear();
+    resource_manager._pending_textures.clear();
+    resource_manager._failed_textures.clear();
+    {
+      std::lock_guard<std::mutex> lock(resource_manager._animation_sets_mutex);
+      resource_manager._animation_sets.clear();
+    }
+    resource_manager._texture_stats.bytes = 0;
+    resource_manager._texture_stats.texture_count = 0;
+  }
 
-    return resource_manager._textures[adjusted_file_path.string()];
+  static std::shared_ptr<const AnimationSet>
+  find_animation_set(const std::string &key) {
+    auto &resource_manager = instance();
+    std::lock_guard<std::mutex> lock(resource_manager._animation_sets_mutex);
+    auto found_set = resource_manager._animation_sets.find(key);
+    return found_set != resource_manager._animation_sets.end()
+               ? found_set->second
+               : nullptr;
+  }
+
+  static void add_animation_set(const std::string &key,
+                                std::shared_ptr<const AnimationSet> set) {
+    auto &resource_manager = instance();
+    std::lock_guard<std::mutex> lock(resource_manager._animation_sets_mutex);
+    resource_manager._animation_sets[key] = std::move(set);
   }
 
 private:
   ResourceManager() = default;
 
-  ~ResourceManager() {
-    std::for_each(_textures.begin(), _textures.end(), [](auto &entry) {
-      SDL_DestroyTexture(entry.second.get());
-      std::cout << "Successfully destroyed texture: " << entry.first << "\n";
-    });
-    _textures.clear();
-  }
+  // The shared_ptr deleters own the SDL textures.
+  ~ResourceManager() = default;
 
   ResourceManager(const ResourceManager &) = delete;
   ResourceManager &operator=(const ResourceManager &) = delete;
 
-  std::unordered_map<std::string, std::shared_ptr<SDL_Texture>> _textures;
+  struct TextureEntry {
+    std::shared_ptr<SDL_Texture> texture;
+    size_t bytes = 0;
+    uint64_t used_frame = 0;
+    std::list<std::string>::iterator lru;
+  };
+
+  // Most recently used keys at the front.
+  std::list<std::string> _lru;
+  std::unordered_map<std::string, TextureEntry> _textures;
+  TextureCacheStats _texture_stats;
+  // Textures belong to the render thread; animation sets are also looked up
+  // from the simulation thread (hot reload).
+  std::mutex _animation_sets_mutex;
+  std::unordered_map<std::string, std::shared_ptr<const AnimationSet>>
+      _animation_sets;
+  std::unordered_set<std::string> _pending_textures;
+  std::unordered_set<std::string> _failed_textures;
+  std::function<void(const std::string &)> _texture_loader;
+  uint64_t _frame = 0;
+
+  void erase_texture(const std::string &key) {
+    auto found_texture = _textures.find(key);
+    if (found_texture == _textures.end()) {
+      return;
+    }
+
+    _texture_stats.bytes -= found_texture->second.bytes;
+    _lru.erase(found_texture->second.lru);
+    _textures.erase(found_texture);
+    _texture_stats.texture_count = _textures.size();
+  }
+
+  void enforce_texture_budget() {
+    if (_texture_stats.budget_bytes == 0) {
+      return;
+    }
+
+    auto it = _lru.end();
+    while (_texture_stats.bytes > _texture_stats.budget_bytes &&
+           it != _lru.begin()) {
+      --it;
+      auto &entry = _textures.at(*it);
+      if (entry.used_frame + 1 >= _frame || entry.texture.use_count() > 1) {
+        continue;
+      }
+
+      std::string key = *it++;
+      if (utils::Log::verbose())
+        std::cout << "Evicting texture: " << key << " (" << entry.bytes
+                  << " bytes)\n";
+      _texture_stats.evictions++;
+      erase_texture(key);
+    }
+  }
 };
 
 } // namespace managers
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "SDL_render.h"
+#include "SDL_rect.h"
+#include "render/render_snapshot.hpp"
 #include <string>
 
 namespace wbz {
@@ -13,7 +14,7 @@ public:
   void set_map_file(const std::string &map_path);
   void set_map_rect(const SDL_Rect &map_rect);
 
-  void render(SDL_Renderer *renderer);
+  void snapshot(RenderSnapshot &snapshot) const;
   void update(float delta_time);
 
 private:
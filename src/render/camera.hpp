@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SDL_rect.h"
+#include <cmath>
+
+namespace wbz {
+
+// World-to-screen transform, screen = (world + offset) * scale, applied on
+// the CPU while building draw calls so anything outside view() is dropped
+// before it reaches SDL.
+class Camera {
+public:
+  void set(float scale, float x_offset, float y_offset, int screen_width,
+           int screen_height) {
+    _scale = scale;
+    _x_offset = x_offset;
+    _y_offset = y_offset;
+    _screen = {0, 0, screen_width, screen_height};
+    _view = {-x_offset, -y_offset, screen_width / scale,
+             screen_height / scale};
+  }
+
+  float scale() const { return _scale; }
+  const SDL_FRect &view() const { return _view; }
+  // The screen rectangle, which is also the map's extent in world space.
+  const SDL_Rect &screen() const { return _screen; }
+
+  bool is_visible(const SDL_Rect &world) const {
+    return world.x < _view.x + _view.w && world.x + world.w > _view.x &&
+           world.y < _view.y + _view.h && world.y + world.h > _view.y;
+  }
+
+  SDL_Point to_screen(int x, int y) const {
+    return {static_cast<int>(std::lround((x + _x_offset) * _scale)),
+            static_cast<int>(std::lround((y + _y_offset) * _scale))};
+  }
+
+  SDL_Rect to_screen(const SDL_Rect &world) const {
+    SDL_Point top_left = to_screen(world.x, world.y);
+    SDL_Point bottom_right = to_screen(world.x + world.w, world.y + world.h);
+    return {top_left.x, top_left.y, bottom_right.x - top_left.x,
+            bottom_right.y - top_left.y};
+  }
+
+private:
+  float _scale = 1.0f;
+  float _x_offset = 0.0f;
+  float _y_offset = 0.0f;
+  SDL_FRect _view = {0.0f, 0.0f, 0.0f, 0.0f};
+  SDL_Rect _screen = {0, 0, 0, 0};
+};
+
+} // namespace wbz
@@ -0,0 +1,145 @@
+#include "debug_draw.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace wbz {
+
+namespace {
+constexpr size_t CIRCLE_SEGMENTS = 64;
+
+struct UnitCircle {
+  std::array<float, CIRCLE_SEGMENTS + 1> cos;
+  std::array<float, CIRCLE_SEGMENTS + 1> sin;
+
+  UnitCircle() {
+    for (size_t i = 0; i <= CIRCLE_SEGMENTS; ++i) {
+      double angle = 2.0 * M_PI * i / CIRCLE_SEGMENTS;
+      cos[i] = static_cast<float>(std::cos(angle));
+      sin[i] = static_cast<float>(std::sin(angle));
+    }
+  }
+};
+
+const UnitCircle &unit_circle() {
+  static const UnitCircle circle;
+  return circle;
+}
+} // namespace
+
+const char *DebugDraw::name(DebugCategory category) {
+  switch (category) {
+  case DebugCategory::BOUNDS:
+    return "bounds";
+  case DebugCategory::HURT_BOXES:
+    return "hurt boxes";
+  case DebugCategory::HIT_BOXES:
+    return "hit boxes";
+  case DebugCategory::RADAR:
+    return "radar";
+  default:
+    return "unknown";
+  }
+}
+
+void DebugDraw::begin_polyline(SDL_Color color) {
+  _polylines.push_back(
+      {static_cast<uint32_t>(_points.size()), 0, color, {0, 0, 0, 0}});
+}
+
+void DebugDraw::end_polyline() {
+  Polyline &polyline = _polylines.back();
+  polyline.count = static_cast<uint32_t>(_points.size()) - polyline.first;
+
+  int min_x = _points[polyline.first].x, max_x = min_x;
+  int min_y = _points[polyline.first].y, max_y = min_y;
+  for (uint32_t i = polyline.first + 1; i < _points.size(); ++i) {
+    min_x = std::min(min_x, _points[i].x);
+    max_x = std::max(max_x, _points[i].x);
+    min_y = std::min(min_y, _points[i].y);
+    max_y = std::max(max_y, _points[i].y);
+  }
+  polyline.bounds = {min_x, min_y, max_x - min_x + 1, max_y - min_y + 1};
+}
+
+void DebugDraw::line(DebugCategory category, int x1, int y1, int x2, int y2,
+                     SDL_Color color) {
+  if (!enabled(category))
+    return;
+
+  begin_polyline(color);
+  _points.push_back({x1, y1});
+  _points.push_back({x2, y2});
+  end_polyline();
+}
+
+void DebugDraw::arrow(DebugCategory category, int x1, int y1, int x2, int y2,
+                      SDL_Color color, int head_size) {
+  if (!enabled(category))
+    return;
+
+  float dx = static_cast<float>(x2 - x1);
+  float dy = static_cast<float>(y2 - y1);
+  float length = std::sqrt(dx * dx + dy * dy);
+  if (length <= 0.0f) {
+    return;
+  }
+  dx = dx / length * head_size;
+  dy = dy / length * head_size;
+
+  // Shaft and head as a single polyline: tail, tip, barb, tip, barb.
+  begin_polyline(color);
+  _points.push_back({x1, y1});
+  _points.push_back({x2, y2});
+  _points.push_back({static_cast<int>(x2 - dx - dy),
+                     static_cast<int>(y2 - dy + dx)});
+  _points.push_back({x2, y2});
+  _points.push_back({static_cast<int>(x2 - dx + dy),
+                     static_cast<int>(y2 - dy - dx)});
+  end_polyline();
+}
+
+void DebugDraw::rect(DebugCategory category, const SDL_Rect &rect,
+                     SDL_Color color) {
+  if (!enabled(category))
+    return;
+
+  const int right = rect.x + rect.w - 1;
+  const int bottom = rect.y + rect.h - 1;
+
+  begin_polyline(color);
+  _points.push_back({rect.x, rect.y});
+  _points.push_back({right, rect.y});
+  _points.push_back({right, bottom});
+  _points.push_back({rect.x, bottom});
+  _points.push_back({rect.x, rect.y});
+  end_polyline();
+}
+
+void DebugDraw::fill_rect(DebugCategory category, const SDL_Rect &rect,
+                          SDL_Color color) {
+  if (!enabled(category))
+    return;
+
+  _quads.push_back({rect, color});
+}
+
+void DebugDraw::circle(DebugCategory category, const Vector2f &center,
+                       float radius, SDL_Color color) {
+  if (!enabled(category))
+    return;
+
+  // Fewer segments for small circles.
+  const size_t stride = radius < 32.0f ? 4 : radius < 96.0f ? 2 : 1;
+  const UnitCircle &circle = unit_circle();
+
+  begin_polyline(color);
+  for (size_t i = 0; i <= CIRCLE_SEGMENTS; i += stride) {
+    _points.push_back(
+        {static_cast<int>(center.x + radius * circle.cos[i]),
+         static_cast<int>(center.y + radius * circle.sin[i])});
+  }
+  end_polyline();
+}
+
+} // namespace wbz
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "SDL_pixels.h"
+#include "SDL_rect.h"
+#include "math/vector2.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace wbz {
+
+enum class DebugCategory : uint8_t {
+  BOUNDS,
+  HURT_BOXES,
+  HIT_BOXES,
+  RADAR,
+  COUNT
+};
+
+// Immediate-mode debug shapes. Outlines are accumulated as polylines in one
+// point buffer and filled shapes as quads, which the Renderer flushes with
+// one SDL_RenderDrawLines per polyline and a single SDL_RenderGeometry.
+// Every call is a no-op while its category is disabled, so overlays that are
+// off cost nothing beyond the check.
+class DebugDraw {
+public:
+  struct Polyline {
+    uint32_t first;
+    uint32_t count;
+    SDL_Color color;
+    // World-space bounds, for culling.
+    SDL_Rect bounds;
+  };
+
+  struct Quad {
+    SDL_Rect rect;
+    SDL_Color color;
+  };
+
+  static bool enabled(DebugCategory category) {
+    return enabled_mask().load(std::memory_order_relaxed) &
+           bit(category);
+  }
+
+  // Returns whether the category is now enabled.
+  static bool toggle(DebugCategory category) {
+    return !(enabled_mask().fetch_xor(bit(category)) & bit(category));
+  }
+
+  static const char *name(DebugCategory category);
+
+  void clear() {
+    _points.clear();
+    _polylines.clear();
+    _quads.clear();
+  }
+
+  void line(DebugCategory category, int x1, int y1, int x2, int y2,
+            SDL_Color color);
+  void arrow(DebugCategory category, int x1, int y1, int x2, int y2,
+             SDL_Color color, int head_size = 6);
+  void rect(DebugCategory category, const SDL_Rect &rect, SDL_Color color);
+  void fill_rect(DebugCategory category, const SDL_Rect &rect,
+                 SDL_Color color);
+  void circle(DebugCategory category, const Vector2f &center, float radius,
+              SDL_Color color);
+
+  const std::vector<SDL_Point> &points() const { return _points; }
+  const std::vector<Polyline> &polylines() const { return _polylines; }
+  const std::vector<Quad> &quads() const { return _quads; }
+
+private:
+  std::vector<SDL_Point> _points;
+  std::vector<Polyline> _polylines;
+  std::vector<Quad> _quads;
+
+  static std::atomic<uint32_t> &enabled_mask() {
+    static std::atomic<uint32_t> mask{
+        (1u << static_cast<uint32_t>(DebugCategory::COUNT)) - 1};
+    return mask;
+  }
+
+  static uint32_t bit(DebugCategory category) {
+    return 1u << static_cast<uint32_t>(category);
+  }
+
+  void begin_polyline(SDL_Color color);
+  void end_polyline();
+};
+
+} // namespace wbz
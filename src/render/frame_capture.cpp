@@ -0,0 +1,106 @@
+#include "frame_capture.hpp"
+#include "utils/hash.hpp"
+#include <cinttypes>
+#include <cstring>
+#include <stdexcept>
+
+namespace wbz {
+
+namespace {
+std::FILE *open_capture_file(const std::string &path, const char *mode) {
+  if (path.empty()) {
+    return nullptr;
+  }
+
+  std::FILE *file = std::fopen(path.c_str(), mode);
+  if (!file) {
+    throw std::runtime_error("Failed to open capture file: " + path);
+  }
+  return file;
+}
+} // namespace
+
+void FrameCapture::open(const CaptureConfig &config) {
+  close();
+  _config = config;
+  _frames = 0;
+
+  _output = open_capture_file(_config.output, "wb");
+  _hashes = open_capture_file(_config.hashes, "w");
+  _timings = open_capture_file(_config.timings, "w");
+
+  if (_timings) {
+    std::fprintf(_timings,
+                 "frame,map_ms,sprites_ms,bars_ms,debug_ms,text_ms,present_ms,"
+                 "total_ms\n");
+  }
+}
+
+void FrameCapture::close() {
+  for (std::FILE **file : {&_output, &_hashes, &_timings}) {
+    if (*file) {
+      std::fclose(*file);
+      *file = nullptr;
+    }
+  }
+}
+
+bool FrameCapture::capture(SDL_Surface *surface,
+                           const RenderTimings &timings) {
+  if (!surface) {
+    return false;
+  }
+
+  // The surface rows may be padded; hash and write only the visible pixels.
+  const size_t row_bytes = static_cast<size_t>(surface->w) * 4;
+  _pixels.resize(row_bytes * surface->h);
+
+  SDL_LockSurface(surface);
+  const auto *source = static_cast<const uint8_t *>(surface->pixels);
+  for (int y = 0; y < surface->h; ++y) {
+    std::memcpy(&_pixels[y * row_bytes], source + y * surface->pitch,
+                row_bytes);
+  }
+  SDL_UnlockSurface(surface);
+
+  // Hash before write_frame(), which repacks the pixels for PPM.
+  if (_hashes) {
+    std::fprintf(_hashes, "%" PRIu64 " %016" PRIx64 "\n", _frames,
+                 utils::Hash::of(_pixels.data(), _pixels.size()));
+  }
+
+  write_frame(surface->w, surface->h);
+
+  if (_timings) {
+    std::fprintf(_timings, "%" PRIu64 ",%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                 _frames, timings.map, timings.sprites, timings.bars,
+                 timings.debug, timings.text, timings.present,
+                 timings.total());
+  }
+
+  ++_frames;
+  return _config.frame_count == 0 || _frames < _config.frame_count;
+}
+
+void FrameCapture::write_frame(int width, int height) {
+  if (!_output) {
+    return;
+  }
+
+  if (_config.format == CaptureFormat::RGBA) {
+    std::fwrite(_pixels.data(), 1, _pixels.size(), _output);
+  } else {
+    // PPM has no alpha channel; drop it in place.
+    std::fprintf(_output, "P6\n%d %d\n255\n", width, height);
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixel_count; ++i) {
+      std::memmove(&_pixels[i * 3], &_pixels[i * 4], 3);
+    }
+    std::fwrite(_pixels.data(), 1, pixel_count * 3, _output);
+  }
+
+  // Keep pipes fed frame by frame.
+  std::fflush(_output);
+}
+
+} // namespace wbz
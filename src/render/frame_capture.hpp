@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SDL_surface.h"
+#include "config/config.hpp"
+#include "render/renderer.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace wbz {
+
+// Writes offscreen frames out as a raw RGBA or PPM stream, a 64-bit FNV-1a
+// hash per frame for golden comparisons and per-frame subsystem timings.
+class FrameCapture {
+public:
+  FrameCapture() = default;
+  ~FrameCapture() { close(); }
+
+  FrameCapture(const FrameCapture &) = delete;
+  FrameCapture &operator=(const FrameCapture &) = delete;
+
+  void open(const CaptureConfig &config);
+  void close();
+
+  // Returns false once the configured number of frames was captured.
+  bool capture(SDL_Surface *surface, const RenderTimings &timings);
+
+  uint64_t frames() const { return _frames; }
+
+private:
+  CaptureConfig _config;
+  std::FILE *_output = nullptr;
+  std::FILE *_hashes = nullptr;
+  std::FILE *_timings = nullptr;
+  uint64_t _frames = 0;
+
+  // Tightly packed pixels of the current frame.
+  std::vector<uint8_t> _pixels;
+
+  void write_frame(int width, int height);
+};
+
+} // namespace wbz
@@ -0,0 +1,174 @@
+#include "frame_pacer.hpp"
+#include "SDL_timer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace wbz {
+
+size_t FrameTimeHistogram::bucket(double ms) {
+  return std::min(BUCKETS - 1, static_cast<size_t>(ms / BUCKET_MS));
+}
+
+void FrameTimeHistogram::add(double ms) {
+  if (_count == WINDOW) {
+    const float evicted = _samples[_next];
+    --_buckets[bucket(evicted)];
+    _sum -= evicted;
+    _janks -= evicted > _jank_ms;
+  } else {
+    ++_count;
+  }
+
+  _samples[_next] = static_cast<float>(ms);
+  _next = (_next + 1) % WINDOW;
+  ++_buckets[bucket(ms)];
+  _sum += static_cast<float>(ms);
+
+  const bool jank = static_cast<float>(ms) > _jank_ms;
+  _janks += jank;
+  _total_janks += jank;
+  ++_total_frames;
+}
+
+double FrameTimeHistogram::percentile(double fraction) const {
+  const uint64_t rank = static_cast<uint64_t>(fraction * _count + 0.5);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    seen += _buckets[i];
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      return (i + 1) * BUCKET_MS;
+    }
+  }
+  return BUCKETS * BUCKET_MS;
+}
+
+FrameStats FrameTimeHistogram::stats() const {
+  FrameStats stats;
+  if (_count == 0) {
+    return stats;
+  }
+
+  stats.frames = _count;
+  stats.average_ms = _sum / _count;
+  stats.p50_ms = percentile(0.50);
+  stats.p95_ms = percentile(0.95);
+  stats.p99_ms = percentile(0.99);
+  stats.janks = _janks;
+  return stats;
+}
+
+void FramePacer::configure(PacingMode mode, uint16_t fps) {
+  _mode = fps == 0 ? PacingMode::OFF : mode;
+  _fps = fps;
+  _frequency = SDL_GetPerformanceFrequency();
+  _period = fps ? _frequency / fps : 0;
+  _deadline = 0;
+  _last_present = 0;
+  _spin_margin = _frequency / 1000.0;
+  _fast_presents = 0;
+  _probed_presents = 0;
+
+  if (fps) {
+    _histogram.set_jank_threshold(1500.0 / fps);
+  }
+}
+
+void FramePacer::end_frame(bool presented) {
+  const uint64_t now = SDL_GetPerformanceCounter();
+
+  if (presented) {
+    if (_last_present) {
+      const uint64_t interval = now - _last_present;
+      _histogram.add(interval * 1000.0 / _frequency);
+
+      if (_mode == PacingMode::VSYNC && _probed_presents < VSYNC_PROBE_FRAMES) {
+        ++_probed_presents;
+        _fast_presents += interval < _period / 2;
+        if (_probed_presents == VSYNC_PROBE_FRAMES &&
+            _fast_presents > VSYNC_PROBE_FRAMES / 2) {
+          std::cout << "Presents are not synced to " << _fps
+                    << " fps, pacing with sleep and spin instead\n";
+          _mode = PacingMode::HYBRID;
+        }
+      }
+    }
+    _last_present = now;
+  }
+
+  switch (_mode) {
+  case PacingMode::OFF:
+    break;
+  case PacingMode::VSYNC:
+    // A presented frame already waited for the display.
+    if (!presented) {
+      wait_until_deadline();
+    }
+    break;
+  case PacingMode::HYBRID:
+    wait_until_deadline();
+    break;
+  }
+}
+
+void FramePacer::wait_until_deadline() {
+  uint64_t now = SDL_GetPerformanceCounter();
+  _deadline += _period;
+  // Fell more than a frame behind: start over instead of rushing to catch up.
+  if (_deadline + _period < now) {
+    _deadline = now;
+    return;
+  }
+  if (_deadline <= now) {
+    return;
+  }
+
+  const double remaining = static_cast<double>(_deadline - now);
+  if (remaining > _spin_margin) {
+    const double sleep_ticks = remaining - _spin_margin;
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(sleep_ticks / _frequency));
+
+    // Track how late sleeps wake up, and spin for a bit more than that.
+    const uint64_t woke = SDL_GetPerformanceCounter();
+    const double oversleep =
+        std::max(0.0, static_cast<double>(woke - now) - sleep_ticks);
+    _spin_margin = std::clamp(0.9 * _spin_margin + 0.1 * 1.5 * oversleep,
+                              _frequency / 4000.0, _frequency / 250.0);
+  }
+
+  while (SDL_GetPerformanceCounter() < _deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::dump(const std::string &path) const {
+  std::FILE *file = std::fopen(path.c_str(), "w");
+  if (!file) {
+    throw std::runtime_error("Failed to open frame stats file: " + path);
+  }
+
+  const FrameStats window = stats();
+  std::fprintf(file,
+               "# frames %llu, janks %llu; last %llu frames: average %.3f ms, "
+               "p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, janks %llu\n",
+               static_cast<unsigned long long>(_histogram.total_frames()),
+               static_cast<unsigned long long>(_histogram.total_janks()),
+               static_cast<unsigned long long>(window.frames),
+               window.average_ms, window.p50_ms, window.p95_ms, window.p99_ms,
+               static_cast<unsigned long long>(window.janks));
+  std::fprintf(file, "bucket_ms,frames\n");
+  const auto &buckets = _histogram.buckets();
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    if (buckets[i]) {
+      std::fprintf(file, "%.2f,%u\n", i * FrameTimeHistogram::BUCKET_MS,
+                   buckets[i]);
+    }
+  }
+  std::fclose(file);
+}
+
+} // namespace wbz
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "config/config.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wbz {
+
+struct FrameStats {
+  uint64_t frames = 0;
+  double average_ms = 0.0;
+  double p50_ms = 0.0;
+  double p95_ms = 0.0;
+  double p99_ms = 0.0;
+  // Frames that took more than 1.5 target frame times.
+  uint64_t janks = 0;
+};
+
+// Rolling histogram of the last WINDOW frame times in BUCKET_MS buckets.
+// Adding a frame moves two bucket counts, and percentiles walk the buckets,
+// so neither depends on the window size.
+class FrameTimeHistogram {
+public:
+  static constexpr size_t WINDOW = 600;
+  static constexpr double BUCKET_MS = 0.25;
+  // The last bucket collects everything from 100 ms up.
+  static constexpr size_t BUCKETS = 400;
+
+  void set_jank_threshold(double ms) { _jank_ms = ms; }
+
+  void add(double ms);
+  FrameStats stats() const;
+
+  uint64_t total_frames() const { return _total_frames; }
+  uint64_t total_janks() const { return _total_janks; }
+  const std::array<uint32_t, BUCKETS> &buckets() const { return _buckets; }
+
+private:
+  std::array<float, WINDOW> _samples{};
+  std::array<uint32_t, BUCKETS> _buckets{};
+  size_t _next = 0;
+  size_t _count = 0;
+  double _sum = 0.0;
+  uint64_t _janks = 0;
+
+  uint64_t _total_frames = 0;
+  uint64_t _total_janks = 0;
+  double _jank_ms = 1e9;
+
+  static size_t bucket(double ms);
+  double percentile(double fraction) const;
+};
+
+// Caps the main loop at the configured frame rate. VSYNC lets
+// SDL_RenderPresent block, and falls back to HYBRID when presents come back
+// much faster than the target (vsync forced off by the driver, or a display
+// refreshing far above it). HYBRID sleeps for most of the remaining frame
+// time and spins the rest; the spin margin tracks how late sleeps wake up.
+class FramePacer {
+public:
+  void configure(PacingMode mode, uint16_t fps);
+
+  PacingMode mode() const { return _mode; }
+
+  // Call once per main-loop iteration: records the frame time when a frame
+  // was presented, then waits until the next frame is due.
+  void end_frame(bool presented);
+
+  FrameStats stats() const { return _histogram.stats(); }
+  const FrameTimeHistogram &histogram() const { return _histogram; }
+
+  // Writes the summary and the bucket counts as CSV.
+  void dump(const std::string &path) const;
+
+private:
+  PacingMode _mode = PacingMode::OFF;
+  uint16_t _fps = 0;
+  uint64_t _period = 0;
+  uint64_t _frequency = 1;
+
+  uint64_t _deadline = 0;
+  uint64_t _last_present = 0;
+  // Expected oversleep, in performance counter ticks.
+  double _spin_margin = 0.0;
+
+  // Presents that came back too fast for vsync to be working.
+  static constexpr uint32_t VSYNC_PROBE_FRAMES = 120;
+  uint32_t _fast_presents = 0;
+  uint32_t _probed_presents = 0;
+
+  FrameTimeHistogram _histogram;
+
+  void wait_until_deadline();
+};
+
+} // namespace wbz
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "SDL_pixels.h"
+#include "SDL_rect.h"
+#include "math/vector2.hpp"
+#include "render/debug_draw.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace wbz {
+
+struct SpriteCommand {
+  std::string texture_id;
+  SDL_Rect src_rect;
+  SDL_Rect dst_rect;
+  bool flip;
+};
+
+struct RectCommand {
+  SDL_Rect rect;
+  SDL_Color color;
+};
+
+struct TextCommand {
+  static constexpr size_t TEXT_LENGTH = 32;
+
+  char text[TEXT_LENGTH];
+  int x, y;
+  SDL_Color color;
+  int size;
+};
+
+struct HudSnapshot {
+  float round_timer = 0.0f;
+  int round_number = 0;
+  int player_rounds_won = 0;
+  int opponent_rounds_won = 0;
+};
+
+// Everything the renderer needs to draw one frame, copied out of the
+// simulation so drawing never reads live game state. Snapshots are recycled
+// through a TripleBuffer; clear() keeps the vectors' capacity so steady-state
+// publishing does not allocate.
+struct RenderSnapshot {
+  std::string map_texture_id;
+  SDL_Rect map_rect{0, 0, 0, 0};
+
+  std::vector<SpriteCommand> sprites;
+  std::vector<RectCommand> bars;
+  std::vector<TextCommand> texts;
+  DebugDraw debug;
+
+  HudSnapshot hud;
+
+  // Points the camera keeps in view.
+  bool has_focus = false;
+  Vector2f focus_a, focus_b;
+
+  uint64_t tick = 0;
+
+  void clear() {
+    map_texture_id.clear();
+    sprites.clear();
+    bars.clear();
+    texts.clear();
+    debug.clear();
+    hud = {};
+    has_focus = false;
+  }
+
+  void add_sprite(const std::string &texture_id, const SDL_Rect &src_rect,
+                  const SDL_Rect &dst_rect, bool flip) {
+    sprites.emplace_back();
+    SpriteCommand &command = sprites.back();
+    command.texture_id = texture_id;
+    command.src_rect = src_rect;
+    command.dst_rect = dst_rect;
+    command.flip = flip;
+  }
+
+  void add_bar(const SDL_Rect &rect, SDL_Color color) {
+    bars.push_back({rect, color});
+  }
+
+  template <typename... Args>
+  void add_text(int x, int y, SDL_Color color, int size, const char *format,
+                Args... args) {
+    texts.emplace_back();
+    TextCommand &command = texts.back();
+    std::snprintf(command.text, TextCommand::TEXT_LENGTH, format, args...);
+    command.x = x;
+    command.y = y;
+    command.color = color;
+    command.size = size;
+  }
+};
+
+} // namespace wbz
@@ -0,0 +1,248 @@
+#include "renderer.hpp"
+#include "managers/resource_manager/resource_manager.hpp"
+#include "text/text_renderer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace wbz {
+
+void Renderer::draw(SDL_Renderer *renderer, const RenderSnapshot &snapshot,
+                    double delta_time, int screen_width, int screen_height) {
+  managers::ResourceManager::begin_frame();
+  update_camera(snapshot, delta_time, screen_width, screen_height);
+  _drawn = 0;
+  _culled = 0;
+
+  const double ticks_per_ms = SDL_GetPerformanceFrequency() / 1000.0;
+  Uint64 lap_start = SDL_GetPerformanceCounter();
+  auto lap = [&]() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double elapsed = (now - lap_start) / ticks_per_ms;
+    lap_start = now;
+    return elapsed;
+  };
+
+  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+  SDL_RenderClear(renderer);
+
+  draw_map(renderer, snapshot);
+  _last_timings.map = lap();
+  draw_sprites(renderer, snapshot);
+  _last_timings.sprites = lap();
+  draw_debug(renderer, snapshot);
+  _last_timings.debug = lap();
+  draw_bars(renderer, snapshot);
+  _last_timings.bars = lap();
+  draw_texts(renderer, snapshot);
+  draw_hud(renderer, snapshot, screen_width);
+  if (_overlay[0]) {
+    TextRenderer::instance().render_text(renderer, _overlay, 10, 10,
+                                         {255, 255, 0, 255}, 16);
+  }
+  _last_timings.text = lap();
+
+  SDL_RenderPresent(renderer);
+  _last_timings.present = lap();
+
+  _total_timings += _last_timings;
+  ++_frames;
+}
+
+void Renderer::update_camera(const RenderSnapshot &snapshot, double delta_time,
+                             int screen_width, int screen_height) {
+  if (!snapshot.has_focus) {
+    _camera.set(_camera_scale, _camera_x_offset, _camera_y_offset,
+                screen_width, screen_height);
+    return;
+  }
+
+  const Vector2f &a = snapshot.focus_a;
+  const Vector2f &b = snapshot.focus_b;
+  Vector2f midpoint = Vector2f((a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f);
+
+  float dist = a.sub(b).mag();
+
+  float desired = 1.0f - (dist - 300.0f) / 300.0f;
+  // clamp
+  if (desired < _min_scale)
+    desired = _min_scale;
+  if (desired > _max_scale)
+    desired = _max_scale;
+
+  _camera_target_scale = desired;
+
+  float alpha = 3.0f * static_cast<float>(delta_time);
+  _camera_scale += (_camera_target_scale - _camera_scale) * alpha;
+
+  _camera_x_offset = (screen_width * 0.5f) / _camera_scale - midpoint.x;
+  _camera_y_offset = (screen_height * 0.5f) / _camera_scale - midpoint.y;
+
+  // The map covers the screen at scale 1; keep the view inside it, or
+  // centered on it when zoomed out past its edges.
+  auto clamp_offset = [](float offset, float view, float world) {
+    if (view >= world) {
+      return (view - world) * 0.5f;
+    }
+    return std::clamp(offset, view - world, 0.0f);
+  };
+  _camera_x_offset = clamp_offset(_camera_x_offset,
+                                  screen_width / _camera_scale, screen_width);
+  _camera_y_offset = clamp_offset(
+      _camera_y_offset, screen_height / _camera_scale, screen_height);
+
+  _camera.set(_camera_scale, _camera_x_offset, _camera_y_offset, screen_width,
+              screen_height);
+}
+
+void Renderer::draw_map(SDL_Renderer *renderer,
+                        const RenderSnapshot &snapshot) {
+  if (snapshot.map_texture_id.empty()) {
+    return;
+  }
+
+  auto texture =
+      managers::ResourceManager::get_texture(renderer, snapshot.map_texture_id);
+  if (texture == nullptr) {
+    // Still being streamed in by the AssetLoader.
+    return;
+  }
+
+  SDL_Rect dest = _camera.to_screen(_camera.screen());
+  SDL_RenderCopy(renderer, texture.get(), &snapshot.map_rect, &dest);
+}
+
+void Renderer::draw_sprites(SDL_Renderer *renderer,
+                            const RenderSnapshot &snapshot) {
+  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+  for (const auto &sprite : snapshot.sprites) {
+    if (cull(_camera.is_visible(sprite.dst_rect))) {
+      continue;
+    }
+
+    auto texture =
+        managers::ResourceManager::get_texture(renderer, sprite.texture_id);
+    if (texture == nullptr) {
+      continue;
+    }
+
+    SDL_Rect dest = _camera.to_screen(sprite.dst_rect);
+    SDL_Point origin{.x = dest.w / 2, .y = dest.h};
+    SDL_RenderCopyEx(renderer, texture.get(), &sprite.src_rect, &dest, 0.0,
+                     &origin,
+                     sprite.flip ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL);
+  }
+}
+
+void Renderer::draw_debug(SDL_Renderer *renderer,
+                          const RenderSnapshot &snapshot) {
+  const DebugDraw &debug = snapshot.debug;
+
+  // Filled shapes: one geometry call for the whole frame.
+  _debug_vertices.clear();
+  _debug_indices.clear();
+  for (const auto &quad : debug.quads()) {
+    if (cull(_camera.is_visible(quad.rect))) {
+      continue;
+    }
+
+    SDL_Rect dest = _camera.to_screen(quad.rect);
+    const float left = static_cast<float>(dest.x);
+    const float top = static_cast<float>(dest.y);
+    const float right = static_cast<float>(dest.x + dest.w);
+    const float bottom = static_cast<float>(dest.y + dest.h);
+
+    const int first = static_cast<int>(_debug_vertices.size());
+    _debug_vertices.push_back({{left, top}, quad.color, {0.0f, 0.0f}});
+    _debug_vertices.push_back({{right, top}, quad.color, {0.0f, 0.0f}});
+    _debug_vertices.push_back({{right, bottom}, quad.color, {0.0f, 0.0f}});
+    _debug_vertices.push_back({{left, bottom}, quad.color, {0.0f, 0.0f}});
+    for (int index : {0, 1, 2, 0, 2, 3}) {
+      _debug_indices.push_back(first + index);
+    }
+  }
+  if (!_debug_vertices.empty()) {
+    SDL_RenderGeometry(renderer, nullptr, _debug_vertices.data(),
+                       static_cast<int>(_debug_vertices.size()),
+                       _debug_indices.data(),
+                       static_cast<int>(_debug_indices.size()));
+  }
+
+  // Outlines: transform every point once, then one call per polyline,
+  // changing the draw color only between runs of different colors.
+  const auto &points = debug.points();
+  _debug_points.resize(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    _debug_points[i] = _camera.to_screen(points[i].x, points[i].y);
+  }
+
+  bool has_color = false;
+  SDL_Color current = {0, 0, 0, 0};
+  for (const auto &polyline : debug.polylines()) {
+    if (cull(_camera.is_visible(polyline.bounds))) {
+      continue;
+    }
+
+    const SDL_Color &color = polyline.color;
+    if (!has_color || color.r != current.r || color.g != current.g ||
+        color.b != current.b || color.a != current.a) {
+      SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+      current = color;
+      has_color = true;
+    }
+
+    SDL_RenderDrawLines(renderer, &_debug_points[polyline.first],
+                        static_cast<int>(polyline.count));
+  }
+}
+
+void Renderer::draw_bars(SDL_Renderer *renderer,
+                         const RenderSnapshot &snapshot) {
+  for (const auto &bar : snapshot.bars) {
+    if (cull(_camera.is_visible(bar.rect))) {
+      continue;
+    }
+
+    SDL_Rect dest = _camera.to_screen(bar.rect);
+    SDL_SetRenderDrawColor(renderer, bar.color.r, bar.color.g, bar.color.b,
+                           bar.color.a);
+    SDL_RenderFillRect(renderer, &dest);
+  }
+}
+
+void Renderer::draw_texts(SDL_Renderer *renderer,
+                          const RenderSnapshot &snapshot) {
+  auto &text_renderer = TextRenderer::instance();
+  for (const auto &text : snapshot.texts) {
+    // Text keeps its point size at any zoom, so its world footprint grows
+    // as the camera zooms out. The width is a per-glyph estimate.
+    SDL_Rect bounds = {
+        text.x, text.y,
+        static_cast<int>(std::strlen(text.text) * text.size * 0.6f /
+                         _camera.scale()),
+        static_cast<int>(text.size / _camera.scale())};
+    if (cull(_camera.is_visible(bounds))) {
+      continue;
+    }
+
+    SDL_Point position = _camera.to_screen(text.x, text.y);
+    text_renderer.render_text(renderer, text.text, position.x, position.y,
+                              text.color, text.size);
+  }
+}
+
+void Renderer::draw_hud(SDL_Renderer *renderer, const RenderSnapshot &snapshot,
+                        int screen_width) {
+  const HudSnapshot &hud = snapshot.hud;
+  if (hud.round_number == 0) {
+    return;
+  }
+
+  char text[TextCommand::TEXT_LENGTH];
+  std::snprintf(text, sizeof(text), "ROUND %d  %02d  %d - %d",
+                hud.round_number, static_cast<int>(hud.round_timer),
+                hud.player_rounds_won, hud.opponent_rounds_won);
+  TextRenderer::instance().render_text(renderer, text, screen_width / 2 - 90,
+                                       10, {255, 255, 255, 255}, 20);
+}
+
+} // namespace wbz
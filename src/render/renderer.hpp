@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SDL_render.h"
+#include "render/camera.hpp"
+#include "render/render_snapshot.hpp"
+#include <cstdio>
+#include <vector>
+
+namespace wbz {
+
+// Milliseconds spent per subsystem.
+struct RenderTimings {
+  double map = 0.0;
+  double sprites = 0.0;
+  double bars = 0.0;
+  double debug = 0.0;
+  double text = 0.0;
+  double present = 0.0;
+
+  double total() const { return map + sprites + bars + debug + text + present; }
+
+  RenderTimings &operator+=(const RenderTimings &other) {
+    map += other.map;
+    sprites += other.sprites;
+    bars += other.bars;
+    debug += other.debug;
+    text += other.text;
+    present += other.present;
+    return *this;
+  }
+};
+
+// Draws RenderSnapshots. Only ever runs on the thread owning the SDL
+// renderer, and reads nothing but the snapshot and the texture cache.
+class Renderer {
+public:
+  void draw(SDL_Renderer *renderer, const RenderSnapshot &snapshot,
+            double delta_time, int screen_width, int screen_height);
+
+  const RenderTimings &last_timings() const { return _last_timings; }
+  const RenderTimings &total_timings() const { return _total_timings; }
+  uint64_t frames() const { return _frames; }
+
+  // Screen-space text drawn over every frame, empty for none.
+  void set_overlay(const char *text) {
+    std::snprintf(_overlay, sizeof(_overlay), "%s", text);
+  }
+
+  // Draw calls issued and culled by the last frame.
+  size_t last_drawn() const { return _drawn; }
+  size_t last_culled() const { return _culled; }
+
+private:
+  RenderTimings _last_timings;
+  RenderTimings _total_timings;
+  uint64_t _frames = 0;
+  size_t _drawn = 0;
+  size_t _culled = 0;
+
+  Camera _camera;
+  char _overlay[96] = "";
+
+  // Scratch buffers for flushing the debug draw batches.
+  std::vector<SDL_Point> _debug_points;
+  std::vector<SDL_Vertex> _debug_vertices;
+  std::vector<int> _debug_indices;
+  float _camera_scale = 1.0f;
+  float _camera_target_scale = 1.0f;
+  float _min_scale = 0.5f;
+  float _max_scale = 1.2f;
+
+  float _camera_x_offset = 0.0f;
+  float _camera_y_offset = 0.0f;
+
+  void update_camera(const RenderSnapshot &snapshot, double delta_time,
+                     int screen_width, int screen_height);
+
+  bool cull(bool visible) {
+    ++(visible ? _drawn : _culled);
+    return !visible;
+  }
+
+  void draw_map(SDL_Renderer *renderer, const RenderSnapshot &snapshot);
+  void draw_sprites(SDL_Renderer *renderer, const RenderSnapshot &snapshot);
+  void draw_debug(SDL_Renderer *renderer, const RenderSnapshot &snapshot);
+  void draw_bars(SDL_Renderer *renderer, const RenderSnapshot &snapshot);
+  void draw_texts(SDL_Renderer *renderer, const RenderSnapshot &snapshot);
+  void draw_hud(SDL_Renderer *renderer, const RenderSnapshot &snapshot,
+                int screen_width);
+};
+
+} // namespace wbz
@@ -0,0 +1,88 @@
+#include "animation_set.hpp"
+#include "tinyxml/tinyxml2.h"
+#include <stdexcept>
+
+namespace wbz {
+
+using namespace tinyxml2;
+
+void AnimationSet::add_animation(const std::string &name,
+                                 Animation animation) {
+  if (_ids.count(name)) {
+    throw std::invalid_argument("Animation already exists: " + name);
+  }
+  if (_animations.size() >= INVALID_ANIMATION) {
+    throw std::length_error("Too many animations in set");
+  }
+
+  _ids[name] = static_cast<AnimationId>(_animations.size());
+  _names.push_back(name);
+  _animations.push_back(animation);
+}
+
+std::shared_ptr<const AnimationSet>
+AnimationSet::load(const std::string &file_path) {
+  XMLDocument doc;
+  if (doc.LoadFile(file_path.c_str()) != XML_SUCCESS) {
+    throw std::runtime_error("Failed to load animation XML file: " + file_path);
+  }
+
+  XMLElement *root = doc.FirstChildElement("sprites");
+  if (!root) {
+    throw std::runtime_error(
+        "Invalid XML format: Missing <sprites> root element");
+  }
+
+  const char *image = root->Attribute("image");
+  if (!image) {
+    throw std::runtime_error("Missing 'image' attribute in <sprites>");
+  }
+
+  auto set = std::make_shared<AnimationSet>();
+  set->_image = image;
+
+  XMLElement *animation_element = root->FirstChildElement("animation");
+  while (animation_element) {
+    const char *title = animation_element->Attribute("title");
+    if (!title) {
+      throw std::runtime_error("Missing 'title' attribute in <animation>");
+    }
+
+    int delay = 0;
+    animation_element->QueryIntAttribute("delay", &delay);
+
+    Animation animation;
+    animation.delay = static_cast<float>(delay);
+    animation.first_frame = static_cast<uint32_t>(set->_frames.size());
+
+    XMLElement *cut_element = animation_element->FirstChildElement("cut");
+    while (cut_element) {
+      int x, y, w, h;
+      if (cut_element->QueryIntAttribute("x", &x) != XML_SUCCESS ||
+          cut_element->QueryIntAttribute("y", &y) != XML_SUCCESS ||
+          cut_element->QueryIntAttribute("w", &w) != XML_SUCCESS ||
+          cut_element->QueryIntAttribute("h", &h) != XML_SUCCESS) {
+        throw std::runtime_error("Invalid or missing attributes in <cut>");
+      }
+
+      set->_frames.push_back({x, y, w, h});
+
+      cut_element = cut_element->NextSiblingElement("cut");
+    }
+
+    animation.frame_count =
+        static_cast<uint32_t>(set->_frames.size()) - animation.first_frame;
+    if (animation.frame_count == 0) {
+      throw std::runtime_error("Animation " + std::string(title) +
+                               " has no frames");
+    }
+
+    set->add_animation(title, animation);
+
+    animation_element = animation_element->NextSiblingElement("animation");
+  }
+
+  return set;
+}
+
+} // namespace wbz
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SDL_rect.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wbz {
+
+using AnimationId = uint16_t;
+constexpr AnimationId INVALID_ANIMATION = UINT16_MAX;
+
+struct Animation {
+  float delay = 60;
+  uint32_t first_frame = 0;
+  uint32_t frame_count = 0;
+  bool loop = true;
+};
+
+// Immutable set of animations parsed from a sprite-decomposer XML file. A set
+// is loaded once per archetype and shared read-only between every character
+// using it; names are resolved to dense ids at load time so playback never
+// touches strings.
+class AnimationSet {
+public:
+  static std::shared_ptr<const AnimationSet>
+  load(const std::string &file_path);
+
+  AnimationId id(const std::string &name) const {
+    auto it = _ids.find(name);
+    return it != _ids.end() ? it->second : INVALID_ANIMATION;
+  }
+
+  const std::string &name(AnimationId id) const { return _names[id]; }
+  const std::string &image() const { return _image; }
+
+  const Animation &animation(AnimationId id) const { return _animations[id]; }
+  const SDL_Rect &frame(const Animation &animation, uint32_t index) const {
+    return _frames[animation.first_frame + index];
+  }
+
+  size_t size() const { return _animations.size(); }
+
+private:
+  std::string _image;
+  std::vector<Animation> _animations;
+  std::vector<std::string> _names;
+  std::vector<SDL_Rect> _frames;
+  std::unordered_map<std::string, AnimationId> _ids;
+
+  void add_animation(const std::string &name, Animation animation);
+};
+
+} // namespace wbz
@@ -1,47 +1,31 @@
 #pragma once
 
 #include "SDL_rect.h"
-#include <functional>
-#include <string>
-#include <unordered_map>
-#include <vector>
-
-struct Animation {
-  float speed_ms = 100;
-  float delay = 60;
-  std::vector<SDL_Rect> frames;
-  bool loop = true;
-  std::function<void()> on_complete = nullptr;
-};
+#include "sprite/animator/animation_set.hpp"
+#include <memory>
 
 namespace wbz {
+
+// Playback state is only the current animation and the simulation time it
+// started at; the frame to draw is derived from a timestamp on demand, so
+// simulation ticks never step animations.
 class Animator {
 public:
-  Animator();
-  ~Animator();
-
-  void add_animation(const std::string &name, Animation animation);
-  void load_animations(const std::string &file_path);
+  void set_animations(std::shared_ptr<const AnimationSet> animations);
+  const std::shared_ptr<const AnimationSet> &animations() const {
+    return _animations;
+  }
 
-  void play();
-  void play(const std::string &name);
-  void pause();
-  void stop();
+  void play(AnimationId id, double time);
 
-  const SDL_Rect &frame() const;
+  const SDL_Rect &frame(double time) const;
 
-  void update(float delta_time);
-
-  bool is_playing() const { return _is_playing; }
+  AnimationId current() const { return _current; }
 
 private:
-  bool _is_playing = false;
-  int _current_animation_frame_index = 0;
-  float _timer = 0.0;
-
-  std::string _current_animation_name = "";
-  std::unordered_map<std::string, Animation> _animations;
+  std::shared_ptr<const AnimationSet> _animations;
 
-  void reset_animation();
+  AnimationId _current = INVALID_ANIMATION;
+  double _start_time = 0.0;
 };
 } // namespace wbz
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "SDL_render.h"
+#include "render/render_snapshot.hpp"
 #include <SDL_rect.h>
 #include <string>
 
@@ -10,7 +10,7 @@ class Sprite {
 public:
   Sprite(const std::string &texture_id, const SDL_Rect &src_rect,
          const SDL_Rect &dst_rect);
-  void render(SDL_Renderer *renderer, bool flip = false) const;
+  void snapshot(RenderSnapshot &snapshot, bool flip = false) const;
 
   void set_frame(const SDL_Rect &frame);
   void set_position(int x, int y);
@@ -4,6 +4,7 @@
 #include "map/map.hpp"
 #include <entities/character/character.hpp>
 #include <memory>
+#include <utils/hash.hpp>
 #include <vector>
 
 namespace wbz {
@@ -52,6 +53,22 @@ struct GameState {
   CombatRoundState combat_state;
   EpisodeState episode_state;
 
+  // Identical across platforms for the same seed and inputs when running
+  // deterministically.
+  uint64_t checksum(uint64_t tick) const {
+    utils::Hash hash;
+    hash.add(tick);
+    hash.add(combat_state.round_timer);
+    hash.add(combat_state.round_number);
+    hash.add(combat_state.player_rounds_won);
+    hash.add(combat_state.opponent_rounds_won);
+    hash.add(combat_state.round_in_progress);
+    for (const auto &entity : entities) {
+      entity->hash_state(hash);
+    }
+    return hash.value();
+  }
+
   void reset_episode() {
     episode_state.episode_number++;
     episode_state.reset();
@@ -0,0 +1,60 @@
+#include "bitmap_font.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace wbz {
+
+const BitmapFont::Face *BitmapFont::face(int size) const {
+  const Face *best = nullptr;
+  for (const auto &face : faces) {
+    if (!best || std::abs(face.size - size) < std::abs(best->size - size)) {
+      best = &face;
+    }
+  }
+  return best;
+}
+
+std::shared_ptr<const BitmapFont>
+BitmapFont::parse(const std::string &metrics) {
+  auto font = std::make_shared<BitmapFont>();
+
+  std::istringstream lines(metrics);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string tag;
+    fields >> tag;
+
+    if (tag.empty() || tag[0] == '#') {
+      continue;
+    } else if (tag == "atlas") {
+      fields >> font->atlas;
+    } else if (tag == "face") {
+      Face face;
+      fields >> face.size >> face.line_height;
+      font->faces.push_back(face);
+    } else if (tag == "glyph") {
+      if (font->faces.empty()) {
+        throw std::runtime_error("Bitmap font glyph declared before a face");
+      }
+
+      int codepoint;
+      Glyph glyph;
+      fields >> codepoint >> glyph.rect.x >> glyph.rect.y >> glyph.rect.w >>
+          glyph.rect.h >> glyph.advance;
+      if (fields.fail() || codepoint < FIRST_GLYPH || codepoint > LAST_GLYPH) {
+        throw std::runtime_error("Invalid bitmap font glyph: " + line);
+      }
+      font->faces.back().glyphs[codepoint - FIRST_GLYPH] = glyph;
+    }
+  }
+
+  if (font->atlas.empty() || font->faces.empty()) {
+    throw std::runtime_error("Bitmap font metrics have no atlas or faces");
+  }
+
+  return font;
+}
+
+} // namespace wbz
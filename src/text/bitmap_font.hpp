@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL_rect.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wbz {
+
+// Metrics of a font pre-rasterized by tools/font_baker: one atlas image
+// holding the printable ASCII range for every baked size.
+struct BitmapFont {
+  static constexpr int FIRST_GLYPH = 32;
+  static constexpr int LAST_GLYPH = 126;
+  static constexpr int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+
+  struct Glyph {
+    SDL_Rect rect{};
+    int advance = 0;
+  };
+
+  struct Face {
+    int size = 0;
+    int line_height = 0;
+    std::array<Glyph, GLYPH_COUNT> glyphs;
+
+    const Glyph *glyph(char c) const {
+      int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+      return index >= 0 && index < GLYPH_COUNT ? &glyphs[index] : nullptr;
+    }
+  };
+
+  std::string atlas;
+  std::vector<Face> faces;
+
+  // Exact size if baked, otherwise the closest one.
+  const Face *face(int size) const;
+
+  static std::shared_ptr<const BitmapFont> parse(const std::string &metrics);
+};
+
+} // namespace wbz
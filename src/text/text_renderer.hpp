@@ -1,13 +1,26 @@
 #pragma once
 
 #include "utils/r.hpp"
-#include <SDL2/SDL_ttf.h>
+#include <SDL_render.h>
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#ifdef WBZ_BITMAP_FONT
+#include "managers/resource_manager/resource_manager.hpp"
+#include "text/bitmap_font.hpp"
+#else
+#include <SDL2/SDL_ttf.h>
+#endif
+
 namespace wbz {
+
+// Draws text either through SDL_ttf or, when built with WBZ_BITMAP_FONT, from
+// the atlas baked by tools/font_baker (`make fonts`), which needs neither
+// SDL_ttf nor any per-string rasterization.
 class TextRenderer {
 public:
   static TextRenderer &instance() {
@@ -15,20 +28,91 @@ public:
     return instance;
   }
 
+  static const std::vector<int> &font_sizes() {
+    static std::vector<int> sizes = {12, 16, 20, 24, 32};
+    return sizes;
+  }
+
+  static const std::string &font_file() {
+#ifdef WBZ_BITMAP_FONT
+    static std::string file = "baked/pixelify_sans.fnt";
+#else
+    static std::string file = "PixelifySans-Regular.ttf";
+#endif
+    return file;
+  }
+
+#ifdef WBZ_BITMAP_FONT
+  void init() {}
+
+  void set_bitmap_font(std::shared_ptr<const BitmapFont> font) {
+    _bitmap_font = std::move(font);
+  }
+
+  static fs::path atlas_path(const BitmapFont &font) {
+    return fs::path(font_file()).parent_path() / font.atlas;
+  }
+
+  void render_text(SDL_Renderer *renderer, const char *text, int x, int y,
+                   SDL_Color color, int size = 16) {
+    if (!_bitmap_font)
+      return;
+
+    const BitmapFont::Face *face = _bitmap_font->face(size);
+    auto atlas = managers::ResourceManager::get_texture(
+        renderer, fs::path(utils::R::fonts()) / atlas_path(*_bitmap_font),
+        managers::ResourceManager::PathPolicy::ABSOLUTE);
+    if (!face || !atlas)
+      return;
+
+    SDL_SetTextureColorMod(atlas.get(), color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlas.get(), color.a);
+
+    // Baked faces are scaled to the requested size when it was not baked.
+    const float scale = static_cast<float>(size) / face->size;
+    float pen_x = static_cast<float>(x);
+    for (const char *c = text; *c; ++c) {
+      const BitmapFont::Glyph *glyph = face->glyph(*c);
+      if (!glyph)
+        continue;
+
+      SDL_Rect dest = {static_cast<int>(pen_x), y,
+                       static_cast<int>(glyph->rect.w * scale),
+                       static_cast<int>(glyph->rect.h * scale)};
+      SDL_RenderCopy(renderer, atlas.get(), &glyph->rect, &dest);
+      pen_x += glyph->advance * scale;
+    }
+  }
+
+  void cleanup() { _bitmap_font.reset(); }
+#else
+  // Fonts are not opened here; the AssetLoader reads the font file on a
+  // worker and hands the bytes over through add_font().
   void init() {
     if (TTF_Init() == -1) {
       throw std::runtime_error("Failed to initialize SDL_ttf");
     }
-    load_fonts();
   }
 
-  void render_text(SDL_Renderer *renderer, const std::string &text, int x,
-                   int y, SDL_Color color, int size = 16) {
+  bool add_font(int size, std::shared_ptr<const std::vector<uint8_t>> data) {
+    TTF_Font *font = TTF_OpenFontRW(
+        SDL_RWFromConstMem(data->data(), static_cast<int>(data->size())), 1,
+        size);
+    if (!font)
+      return false;
+
+    _fonts[size] = std::shared_ptr<TTF_Font>(font, TTF_CloseFont);
+    _font_data.push_back(std::move(data));
+    return true;
+  }
+
+  void render_text(SDL_Renderer *renderer, const char *text, int x, int y,
+                   SDL_Color color, int size = 16) {
     TTF_Font *font = get_font(size);
     if (!font)
       return;
 
-    SDL_Surface *surface = TTF_RenderText_Blended(font, text.c_str(), color);
+    SDL_Surface *surface = TTF_RenderText_Blended(font, text, color);
     if (!surface)
       return;
 
@@ -43,28 +127,26 @@ public:
 
   void cleanup() {
     _fonts.clear();
+    _font_data.clear();
     TTF_Quit();
   }
+#endif
 
 private:
   TextRenderer() = default;
-  std::unordered_map<int, std::shared_ptr<TTF_Font>> _fonts;
-
-  void load_fonts() {
-    std::vector<int> sizes = {12, 16, 24, 32};
 
-    for (int size : sizes) {
-      TTF_Font *font =
-          TTF_OpenFont((utils::R::fonts() + "seguiemj.ttf").c_str(), size);
-      if (font) {
-        _fonts[size] = std::shared_ptr<TTF_Font>(font, TTF_CloseFont);
-      }
-    }
-  }
+#ifdef WBZ_BITMAP_FONT
+  std::shared_ptr<const BitmapFont> _bitmap_font;
+#else
+  std::unordered_map<int, std::shared_ptr<TTF_Font>> _fonts;
+  // TTF_OpenFontRW streams glyphs from memory, so the bytes must outlive
+  // every font opened from them.
+  std::vector<std::shared_ptr<const std::vector<uint8_t>>> _font_data;
 
   TTF_Font *get_font(int size) {
     auto it = _fonts.find(size);
     return it != _fonts.end() ? it->second.get() : nullptr;
   }
+#endif
 };
 } // namespace wbz
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace wbz {
+namespace utils {
+
+// 64-bit FNV-1a.
+class Hash {
+public:
+  static constexpr uint64_t OFFSET_BASIS = 14695981039346656037ull;
+  static constexpr uint64_t PRIME = 1099511628211ull;
+
+  static uint64_t of(const void *data, size_t size) {
+    Hash hash;
+    hash.add(data, size);
+    return hash.value();
+  }
+
+  void add(const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      _value ^= bytes[i];
+      _value *= PRIME;
+    }
+  }
+
+  // Hashes the object representation; only for padding-free values.
+  template <typename T> void add(const T &value) { add(&value, sizeof(T)); }
+
+  uint64_t value() const { return _value; }
+
+private:
+  uint64_t _value = OFFSET_BASIS;
+};
+
+} // namespace utils
+} // namespace wbz
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+
+namespace wbz {
+namespace utils {
+
+// Toggles the per-tick training and combat chatter on stdout. It is turned
+// off whenever nothing is being presented (headless runs, batch training) so
+// those only pay for gameplay logic.
+struct Log {
+  static std::atomic<bool> &verbose() {
+    static std::atomic<bool> verbose{true};
+    return verbose;
+  }
+};
+
+} // namespace utils
+} // namespace wbz
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+namespace wbz {
+namespace utils {
+
+// PCG32 with its own distributions. Unlike std::uniform_*_distribution the
+// output is specified here, so a seed yields the same sequence with
+// libstdc++ (native) and libc++ (Emscripten).
+class Random {
+public:
+  explicit Random(uint64_t seed = 0, uint64_t stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  // Independent stream seeded from base_seed(); streams are numbered in
+  // creation order, which is deterministic for a given setup.
+  static Random stream() {
+    return Random(base_seed(), next_stream().fetch_add(1));
+  }
+
+  // Fixed by deterministic runs; drawn from std::random_device otherwise.
+  static void set_base_seed(uint64_t seed) {
+    base_seed() = seed;
+    next_stream() = 0;
+  }
+
+  static uint64_t &base_seed() {
+    static uint64_t seed =
+        (static_cast<uint64_t>(std::random_device{}()) << 32) |
+        std::random_device{}();
+    return seed;
+  }
+
+  void seed(uint64_t seed, uint64_t stream) {
+    _state = 0;
+    _increment = (stream << 1u) | 1u;
+    next();
+    _state += seed;
+    next();
+  }
+
+  uint32_t next() {
+    uint64_t old_state = _state;
+    _state = old_state * 6364136223846793005ull + _increment;
+    uint32_t xorshifted =
+        static_cast<uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+    uint32_t rotation = static_cast<uint32_t>(old_state >> 59u);
+    return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31));
+  }
+
+  // Uniform in [0, 1), from the top 24 bits so every value is exact.
+  float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+  // Uniform in [low, high].
+  int range(int low, int high) {
+    uint64_t span = static_cast<uint64_t>(high - low) + 1;
+    return low + static_cast<int>((static_cast<uint64_t>(next()) * span) >> 32);
+  }
+
+private:
+  uint64_t _state = 0;
+  uint64_t _increment = 1;
+
+  static std::atomic<uint64_t> &next_stream() {
+    static std::atomic<uint64_t> stream{0};
+    return stream;
+  }
+};
+
+} // namespace utils
+} // namespace wbz
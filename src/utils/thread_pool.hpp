@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wbz {
+namespace utils {
+
+// Minimal FIFO worker pool. Builds without thread support (Emscripten without
+// pthreads) run jobs inline on the calling thread instead.
+class ThreadPool {
+public:
+  ThreadPool() = default;
+  explicit ThreadPool(size_t worker_count) { start(worker_count); }
+  ~ThreadPool() { stop(); }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void start(size_t worker_count = 0) {
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    if (!_workers.empty())
+      return;
+
+    if (worker_count == 0) {
+      worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    _stopping = false;
+    for (size_t i = 0; i < worker_count; ++i) {
+      _workers.emplace_back([this] { worker_loop(); });
+    }
+#else
+    (void)worker_count;
+#endif
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto &worker : _workers) {
+      worker.join();
+    }
+    _workers.clear();
+  }
+
+  void enqueue(std::function<void()> job) {
+    if (_workers.empty()) {
+      job();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _jobs.push_back(std::move(job));
+    }
+    _condition.notify_one();
+  }
+
+  size_t size() const { return std::max<size_t>(1, _workers.size()); }
+
+  // Runs fn(i) for every i in [0, count) on the workers and the calling
+  // thread, returning once all calls are done. Indices are handed out one at
+  // a time, so uneven work balances itself.
+  template <typename Fn> void parallel_for(size_t count, Fn &&fn) {
+    if (_workers.empty() || count < 2) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto run = [&] {
+      for (size_t i = next++; i < count; i = next++) {
+        fn(i);
+      }
+    };
+
+    const size_t helpers = std::min(_workers.size(), count - 1);
+    std::mutex done_mutex;
+    std::condition_variable done_condition;
+    size_t running = helpers;
+    for (size_t i = 0; i < helpers; ++i) {
+      enqueue([&] {
+        run();
+        std::lock_guard<std::mutex> lock(done_mutex);
+        if (--running == 0) {
+          done_condition.notify_one();
+        }
+      });
+    }
+
+    run();
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_condition.wait(lock, [&] { return running == 0; });
+  }
+
+private:
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void()>> _jobs;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stopping = false;
+
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+        if (_jobs.empty())
+          return;
+
+        job = std::move(_jobs.front());
+        _jobs.pop_front();
+      }
+      job();
+    }
+  }
+};
+
+} // namespace utils
+} // namespace wbz
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace wbz {
+namespace utils {
+
+// Single-producer, single-consumer triple buffer. The writer fills back() and
+// publish()es it; the reader acquire()s the most recently published value
+// into front(). Neither side ever waits on the other: a slow reader just
+// skips intermediate values, a slow writer leaves the reader on the last one.
+template <typename T> class TripleBuffer {
+public:
+  T &back() { return _slots[_back]; }
+
+  void publish() {
+    uint8_t previous =
+        _middle.exchange(static_cast<uint8_t>(_back | DIRTY_BIT),
+                         std::memory_order_acq_rel);
+    _back = previous & INDEX_MASK;
+  }
+
+  // Returns true when a value newer than the current front() was taken.
+  bool acquire() {
+    if (!(_middle.load(std::memory_order_relaxed) & DIRTY_BIT))
+      return false;
+
+    uint8_t previous =
+        _middle.exchange(_front, std::memory_order_acq_rel);
+    _front = previous & INDEX_MASK;
+    return true;
+  }
+
+  const T &front() const { return _slots[_front]; }
+
+private:
+  static constexpr uint8_t DIRTY_BIT = 0x4;
+  static constexpr uint8_t INDEX_MASK = 0x3;
+
+  T _slots[3];
+  uint8_t _back = 0;
+  std::atomic<uint8_t> _middle{1};
+  uint8_t _front = 2;
+};
+
+} // namespace utils
+} // namespace wbz
@@ -26,9 +26,12 @@ wbz::Window wbz::Window::from_config(const WindowConfig &window_config) {
     throw std::runtime_error("Failed to create the SDL2 Window.");
   }
 
-  new_window._renderer.reset(SDL_CreateRenderer(new_window._window.get(), -1,
-                                                SDL_RENDERER_ACCELERATED),
-                             SDL_DestroyRenderer);
+  new_window._renderer.reset(
+      SDL_CreateRenderer(new_window._window.get(), -1,
+                         SDL_RENDERER_ACCELERATED |
+                             (window_config.vsync ? SDL_RENDERER_PRESENTVSYNC
+                                                  : 0)),
+      SDL_DestroyRenderer);
 
   if (!new_window._renderer) {
     std::cerr << "Failed to create the SDL2 Renderer; Error = "
@@ -38,18 +41,60 @@ wbz::Window wbz::Window::from_config(const WindowConfig &window_config) {
     throw std::runtime_error("Failed to create the SDL2 Renderer.");
   }
 
-  if (SDL_SetRenderDrawBlendMode(new_window._renderer.get(),
-                                 SDL_BLENDMODE_BLEND) < 0) {
-    std::cerr << "Failed to set SDL Renderer blend mode; Error = "
+  new_window.set_blend_mode();
+
+  return new_window;
+}
+
+wbz::Window wbz::Window::offscreen(const WindowConfig &window_config) {
+  Window new_window;
+
+  SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+  if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    std::cerr << "Failed to initialize the SDL2 Library; Error = "
+              << SDL_GetError() << std::endl;
+    throw std::runtime_error(
+        "Failed to initialize SDL with the dummy video driver.");
+  }
+
+  new_window._surface.reset(
+      SDL_CreateRGBSurfaceWithFormat(0, window_config.width,
+                                     window_config.height, 32,
+                                     SDL_PIXELFORMAT_RGBA32),
+      SDL_FreeSurface);
+
+  if (!new_window._surface) {
+    std::cerr << "Failed to create the offscreen surface; Error = "
               << SDL_GetError() << std::endl;
-    new_window.cleanup();
     SDL_Quit();
-    throw std::runtime_error("Failed to set SDL Renderer blend mode.");
+    throw std::runtime_error("Failed to create the offscreen surface.");
+  }
+
+  new_window._renderer.reset(
+      SDL_CreateSoftwareRenderer(new_window._surface.get()),
+      SDL_DestroyRenderer);
+
+  if (!new_window._renderer) {
+    std::cerr << "Failed to create the SDL2 software Renderer; Error = "
+              << SDL_GetError() << std::endl;
+    new_window.cleanup();
+    throw std::runtime_error("Failed to create the SDL2 software Renderer.");
   }
 
+  new_window.set_blend_mode();
+
   return new_window;
 }
 
+void wbz::Window::set_blend_mode() {
+  if (SDL_SetRenderDrawBlendMode(_renderer.get(), SDL_BLENDMODE_BLEND) < 0) {
+    std::cerr << "Failed to set SDL Renderer blend mode; Error = "
+              << SDL_GetError() << std::endl;
+    cleanup();
+    throw std::runtime_error("Failed to set SDL Renderer blend mode.");
+  }
+}
+
 void wbz::Window::cleanup() {
   if (_renderer) {
     SDL_DestroyRenderer(_renderer.get());
@@ -61,5 +106,7 @@ void wbz::Window::cleanup() {
     _window = nullptr;
   }
 
+  _surface = nullptr;
+
   SDL_Quit();
 }
@@ -9,14 +9,21 @@ namespace wbz {
 class Window {
 public:
   static Window from_config(const WindowConfig &window_config);
+  // Software renderer drawing into a surface, using the dummy video driver.
+  static Window offscreen(const WindowConfig &window_config);
 
   std::shared_ptr<SDL_Window> window() { return _window; }
   std::shared_ptr<SDL_Renderer> renderer() { return _renderer; }
+  // Only set for offscreen windows.
+  std::shared_ptr<SDL_Surface> surface() { return _surface; }
 
   void cleanup();
 
 private:
   std::shared_ptr<SDL_Window> _window{nullptr, SDL_DestroyWindow};
   std::shared_ptr<SDL_Renderer> _renderer{nullptr, SDL_DestroyRenderer};
+  std::shared_ptr<SDL_Surface> _surface{nullptr, SDL_FreeSurface};
+
+  void set_blend_mode();
 };
 } // namespace wbz
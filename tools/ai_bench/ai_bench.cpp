@@ -0,0 +1,64 @@
+// Measures the per-tick cost of many learning AI characters, each facing
+// an idle opponent, at a given decision interval and per-tick budget.
+//
+// usage: ai_bench [agents] [decision interval] [budget] [ticks]
+
+#include "entities/character/ai_character.hpp"
+#include "utils/log.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+  auto arg = [&](int index, unsigned long fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+  };
+  const size_t agents = arg(1, 256);
+  const uint32_t interval = static_cast<uint32_t>(arg(2, 4));
+  const uint32_t budget = static_cast<uint32_t>(arg(3, 0));
+  const size_t ticks = arg(4, 1200);
+  const double tick_seconds = 1.0 / 120.0;
+
+  wbz::utils::Log::verbose() = false;
+  wbz::ai::DecisionScheduler scheduler(interval, budget);
+
+  wbz::Sprite sprite("goku_ssjb.png", {64, 2271, 64, 64}, {0, 0, 64, 64});
+  std::vector<std::unique_ptr<wbz::entities::Character>> opponents;
+  std::vector<std::unique_ptr<wbz::entities::AICharacter>> characters;
+  for (size_t i = 0; i < agents; ++i) {
+    opponents.push_back(std::make_unique<wbz::entities::Character>(sprite));
+    opponents.back()->mover().set_position(
+        Vector2f(200.0f + (i % 16) * 40.0f, 400.0f));
+
+    characters.push_back(
+        std::make_unique<wbz::entities::AICharacter>(sprite));
+    auto &character = *characters.back();
+    character.mover().set_position(Vector2f(600.0f, 100.0f + i % 32 * 15.0f));
+    character.set_episode_logging(false);
+    character.set_opponent(opponents.back().get());
+    character.set_decision_scheduler(&scheduler);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tick = 0; tick < ticks; ++tick) {
+    scheduler.begin_tick();
+    for (auto &character : characters) {
+      character->update(tick_seconds);
+    }
+  }
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  // Two 120 Hz ticks per 60 FPS frame.
+  const double frame_ms = 2.0 * ms / ticks;
+  std::cout << agents << " agents deciding every " << interval << " ticks: "
+            << ms / ticks << " ms per tick, " << frame_ms
+            << " ms per 60 FPS frame, "
+            << 1e3 * ms / (static_cast<double>(ticks) * agents)
+            << " us per agent tick; " << scheduler.decisions()
+            << " decisions, " << scheduler.deferred() << " deferred\n";
+  return 0;
+}
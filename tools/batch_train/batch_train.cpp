@@ -0,0 +1,81 @@
+// Trains a Q-table offline from trajectory logs written with --trajectory,
+// using parallel fitted Q-iteration, and saves a checkpoint the game loads
+// with --q-table.
+//
+// usage: batch_train <output> <trajectory>... [--threads n]
+//        [--iterations n] [--discount x] [--learning-rate x]
+
+#include "entities/agent/batch_trainer.hpp"
+#include "utils/log.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+  wbz::ai::BatchTrainerConfig config;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--", 0) == 0 && i + 1 < argc) {
+      const char *value = argv[++i];
+      if (arg == "--threads") {
+        config.threads = std::strtoul(value, nullptr, 10);
+      } else if (arg == "--iterations") {
+        config.iterations = std::strtoul(value, nullptr, 10);
+      } else if (arg == "--discount") {
+        config.discount_factor = std::strtof(value, nullptr);
+      } else if (arg == "--learning-rate") {
+        config.learning_rate = std::strtof(value, nullptr);
+      } else {
+        std::cerr << "Unknown argument: " << arg << "\n";
+        return 1;
+      }
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.size() < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <output> <trajectory>... [--threads n] [--iterations n]"
+                 " [--discount x] [--learning-rate x]\n";
+    return 1;
+  }
+
+  wbz::utils::Log::verbose() = false;
+  try {
+    wbz::ai::BatchQTrainer trainer(config);
+    for (size_t i = 1; i < paths.size(); ++i) {
+      wbz::ai::TrajectoryReader reader;
+      reader.open(paths[i]);
+      trainer.add(reader);
+    }
+    std::cout << "Training on " << trainer.transitions() << " transitions\n";
+
+    double seconds = 0.0;
+    uint32_t iterations = 0;
+    while (iterations < config.iterations) {
+      const auto iteration = trainer.iterate();
+      seconds += iteration.seconds;
+      ++iterations;
+      std::cout << "Iteration " << iterations << ": max change "
+                << iteration.max_change << ", " << iteration.seconds * 1e3
+                << " ms\n";
+      if (iteration.max_change <= config.tolerance) {
+        break;
+      }
+    }
+    std::cout << iterations << " iterations in " << seconds << " s, "
+              << iterations * trainer.transitions() / seconds
+              << " transitions/s\n";
+
+    wbz::ai::QLearningAgent agent;
+    trainer.export_to(agent);
+    agent.save_table(paths[0]);
+    std::cout << "Saved Q-table to " << paths[0] << "\n";
+  } catch (const std::exception &e) {
+    std::cerr << "Training failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+// Measures the vectorized environment's step cost through its C interface:
+// steps per second and how much of each step is simulation rather than
+// packing results into the caller's buffers.
+//
+// usage: env_bench [arenas] [threads] [steps] [frame skip]
+
+#include "env/wbz_env.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+  auto arg = [&](int index, unsigned long fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+  };
+
+  wbz_env_config config = {};
+  config.num_arenas = static_cast<uint32_t>(arg(1, 64));
+  config.num_threads = static_cast<uint32_t>(arg(2, 0));
+  const unsigned long steps = arg(3, 2000);
+  config.frame_skip = static_cast<uint32_t>(arg(4, 4));
+  config.max_episode_ticks = 120 * 60;
+  config.seed = 1;
+
+  wbz_env *env = wbz_env_create(&config);
+  if (!env) {
+    std::cerr << "wbz_env_create failed: " << wbz_env_last_error() << "\n";
+    return 1;
+  }
+
+  const size_t arenas = config.num_arenas;
+  std::vector<float> observations(arenas * WBZ_ENV_OBSERVATION_SIZE);
+  std::vector<int32_t> actions(arenas);
+  std::vector<float> rewards(arenas);
+  std::vector<uint8_t> dones(arenas);
+
+  wbz_env_reset(env, observations.data());
+
+  uint32_t lcg = 12345;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned long step = 0; step < steps; ++step) {
+    for (auto &action : actions) {
+      lcg = lcg * 1664525u + 1013904223u;
+      action = static_cast<int32_t>((lcg >> 16) % WBZ_ENV_ACTION_COUNT);
+    }
+    if (wbz_env_step(env, actions.data(), observations.data(), rewards.data(),
+                     dones.data()) != 0) {
+      std::cerr << "wbz_env_step failed: " << wbz_env_last_error() << "\n";
+      wbz_env_destroy(env);
+      return 1;
+    }
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  wbz_env_stats stats;
+  wbz_env_get_stats(env, &stats);
+  wbz_env_destroy(env);
+
+  const double step_ms = seconds * 1000.0 / steps;
+  const double inside_ms = (stats.simulate_ms + stats.marshal_ms) / steps;
+  std::cout << arenas << " arenas, " << steps << " steps in " << seconds
+            << " s\n"
+            << "  " << steps / seconds << " steps/s, "
+            << steps * arenas / seconds << " arena steps/s, "
+            << stats.ticks / seconds << " ticks/s, " << stats.episodes
+            << " episodes\n"
+            << "  per step: " << step_ms << " ms total, "
+            << stats.simulate_ms / steps << " ms simulating, "
+            << stats.marshal_ms / steps << " ms packing results, "
+            << step_ms - inside_ms << " ms outside the env\n";
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Checks the headless arena's combat rules: runs each case and reports the
+// ones that fail, exiting non-zero if any did.
+//
+// usage: env_check
+
+#include "env/arena.hpp"
+#include "utils/log.hpp"
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void check(bool passed, const char *name) {
+  std::cout << (passed ? "pass  " : "FAIL  ") << name << "\n";
+  if (!passed) {
+    ++failures;
+  }
+}
+
+// A greedy agent that picks the same action in every state.
+std::unique_ptr<wbz::ai::QLearningAgent> always(wbz::ai::Action action) {
+  auto agent = std::make_unique<wbz::ai::QLearningAgent>();
+  std::vector<float> values(static_cast<int>(wbz::ai::Action::ACTION_COUNT),
+                            0.0f);
+  values[static_cast<int>(action)] = 1.0f;
+  for (int state = 0; state < wbz::ai::State::COUNT; ++state) {
+    agent->set_q_values(wbz::ai::State::from_index(state), values.data());
+  }
+  agent->set_greedy(true);
+  return agent;
+}
+
+// One attack decision spans frame_skip ticks but starts a single attack.
+void attack_decision_starts_one_attack() {
+  wbz::env::ArenaConfig config;
+  config.agent_control = true;
+  wbz::env::Arena arena(config);
+  arena.learner().swap_agent(always(wbz::ai::Action::LIGHT_PUNCH));
+  arena.learner().set_learning(false);
+
+  const uint32_t before = arena.learner().attacks_started();
+  float reward = 0.0f;
+  arena.step(wbz::ai::Action::IDLE, reward);
+  check(arena.learner().attacks_started() == before + 1,
+        "one attack decision starts one attack");
+}
+
+// A stepped attack runs for frame_skip ticks but starts once, even with the
+// step long enough to reach the attack's cancel window.
+void attack_step_starts_one_attack() {
+  wbz::env::ArenaConfig config;
+  config.frame_skip = 24;
+  wbz::env::Arena arena(config);
+
+  uint32_t before = arena.learner().attacks_started();
+  float reward = 0.0f;
+  arena.step(wbz::ai::Action::LIGHT_PUNCH, reward);
+  check(arena.learner().attacks_started() == before + 1,
+        "one attack step starts one attack");
+
+  before = arena.learner().attacks_started();
+  arena.step(wbz::ai::Action::MOVE_LEFT, reward);
+  check(arena.learner().attacks_started() == before,
+        "a movement step starts no attack");
+}
+} // namespace
+
+int main() {
+  wbz::utils::Log::verbose() = false;
+
+  attack_decision_starts_one_attack();
+  attack_step_starts_one_attack();
+
+  return failures == 0 ? 0 : 1;
+}
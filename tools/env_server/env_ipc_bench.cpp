@@ -0,0 +1,129 @@
+// Benchmarks the shared-memory environment server from a separate client
+// process: the round-trip latency of single lockstep steps, then the
+// throughput of many environments stepped concurrently.
+//
+// usage: env_ipc_bench [environments] [arenas] [steps]
+
+#include "env/env_server.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double elapsed_us(clock_type::time_point start, clock_type::time_point end) {
+  return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// One lockstep request; returns whether the server answered OK.
+bool request(wbz::env::ShmChannel &channel, uint32_t command,
+             uint32_t &random) {
+  auto slot = channel.begin_request();
+  *slot.command = command;
+  for (uint32_t i = 0; i < channel.arenas(); ++i) {
+    random = random * 1664525u + 1013904223u;
+    slot.actions[i] = static_cast<int32_t>((random >> 16) % 10);
+  }
+  channel.end_request();
+
+  auto response = channel.wait_response();
+  const bool ok = *response.status == WBZ_SHM_OK;
+  channel.release_response();
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  auto arg = [&](int index, unsigned long fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+  };
+  const size_t environments = arg(1, 8);
+  const size_t arenas = arg(2, 16);
+  const size_t steps = arg(3, 20000);
+  const std::string name = "bench_" + std::to_string(getpid());
+
+  pid_t server = fork();
+  if (server == 0) {
+    wbz::env::EnvServer(name, environments, arenas, {}, 1).run();
+    _exit(0);
+  }
+
+  try {
+    std::vector<wbz::env::ShmChannel> channels;
+    for (size_t i = 0; i < environments; ++i) {
+      channels.push_back(wbz::env::ShmChannel::open(
+          wbz::env::ShmChannel::segment_name(name, i)));
+    }
+
+    // Latency: one client, nothing else running.
+    uint32_t random = 1;
+    request(channels[0], WBZ_SHM_RESET, random);
+    std::vector<double> round_trips(steps);
+    for (size_t i = 0; i < steps; ++i) {
+      auto start = clock_type::now();
+      request(channels[0], WBZ_SHM_STEP, random);
+      round_trips[i] = elapsed_us(start, clock_type::now());
+    }
+    std::sort(round_trips.begin(), round_trips.end());
+
+    // The same step in process, to separate simulation from transport.
+    wbz::env::VectorEnv local(arenas, {}, 1, 1);
+    std::vector<int32_t> actions(arenas, 0);
+    std::vector<float> observations(arenas *
+                                    wbz::env::Arena::OBSERVATION_SIZE);
+    std::vector<float> rewards(arenas);
+    std::vector<uint8_t> dones(arenas);
+    local.reset(observations.data());
+    auto local_start = clock_type::now();
+    for (size_t i = 0; i < steps; ++i) {
+      local.step(actions.data(), observations.data(), rewards.data(),
+                 dones.data());
+    }
+    const double local_us = elapsed_us(local_start, clock_type::now()) / steps;
+
+    std::cout << "Round trip, " << arenas << " arenas per step: p50 "
+              << round_trips[steps / 2] << " us, p99 "
+              << round_trips[steps * 99 / 100] << " us, max "
+              << round_trips.back() << " us (in process " << local_us
+              << " us)\n";
+
+    // Throughput: every environment stepped by its own client thread.
+    std::vector<std::thread> clients;
+    auto start = clock_type::now();
+    for (size_t e = 0; e < environments; ++e) {
+      clients.emplace_back([&channels, e, steps] {
+        uint32_t client_random = static_cast<uint32_t>(e) + 7;
+        request(channels[e], WBZ_SHM_RESET, client_random);
+        for (size_t i = 0; i < steps; ++i) {
+          request(channels[e], WBZ_SHM_STEP, client_random);
+        }
+      });
+    }
+    for (auto &client : clients) {
+      client.join();
+    }
+    const double seconds = elapsed_us(start, clock_type::now()) / 1e6;
+    std::cout << environments << " environments concurrently: "
+              << environments * steps / seconds << " steps/s, "
+              << environments * steps * arenas / seconds
+              << " arena steps/s\n";
+
+    for (auto &channel : channels) {
+      request(channel, WBZ_SHM_CLOSE, random);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Benchmark failed: " << e.what() << "\n";
+    kill(server, SIGTERM);
+  }
+
+  waitpid(server, nullptr, 0);
+  return 0;
+}
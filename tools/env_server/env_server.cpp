@@ -0,0 +1,56 @@
+// Serves training environments to out-of-process agents over shared memory
+// (see src/env/wbz_env_shm.h for the protocol). Runs until every client has
+// closed its environment, or until SIGINT/SIGTERM.
+//
+// usage: env_server <name> [environments] [arenas] [frame skip] [seed]
+
+#include "env/env_server.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <pthread.h>
+#include <thread>
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0]
+              << " <name> [environments] [arenas] [frame skip] [seed]\n";
+    return 1;
+  }
+  auto arg = [&](int index, unsigned long fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+  };
+
+  const std::string name = argv[1];
+  const size_t environments = arg(2, 1);
+  const size_t arenas = arg(3, 1);
+  wbz::env::ArenaConfig config;
+  config.frame_skip = static_cast<uint32_t>(arg(4, 4));
+  const uint64_t seed = arg(5, 0);
+
+  // Signals are taken by a dedicated thread so stop() runs outside of a
+  // signal handler.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  try {
+    wbz::env::EnvServer server(name, environments, arenas, config, seed);
+    std::thread([&server, signals] {
+      int signal = 0;
+      sigwait(&signals, &signal);
+      server.stop();
+    }).detach();
+
+    std::cout << "Serving " << environments << " environments of " << arenas
+              << " arenas at " << wbz::env::ShmChannel::segment_name(name, 0)
+              << (environments > 1 ? "..." : "") << "\n";
+    server.run();
+  } catch (const std::exception &e) {
+    std::cerr << "Environment server failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
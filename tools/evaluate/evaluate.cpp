@@ -0,0 +1,98 @@
+// Evaluates a frozen Q-table policy over seeded matches against the
+// scripted opponent and/or older checkpoints, and reports win rates with
+// confidence intervals, damage, round length and throughput.
+//
+// usage: evaluate <qtable> [--opponent scripted|<qtable>]... [--matches n]
+//        [--threads n] [--seed n] [--seconds n]
+
+#include "env/evaluation.hpp"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+void print_estimate(const char *name, const wbz::env::Estimate &estimate,
+                    const char *unit) {
+  std::cout << "  " << std::left << std::setw(14) << name << std::right
+            << std::setw(8) << estimate.value << unit << "  ["
+            << estimate.low << ", " << estimate.high << "]\n";
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  wbz::env::EvaluationConfig config;
+  std::string policy_path;
+  std::vector<std::string> opponents;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--", 0) == 0 && i + 1 < argc) {
+      const char *value = argv[++i];
+      if (arg == "--opponent") {
+        opponents.push_back(value);
+      } else if (arg == "--matches") {
+        config.matches = std::strtoul(value, nullptr, 10);
+      } else if (arg == "--threads") {
+        config.threads = std::strtoul(value, nullptr, 10);
+      } else if (arg == "--seed") {
+        config.seed = std::strtoull(value, nullptr, 10);
+      } else if (arg == "--seconds") {
+        config.arena.max_episode_ticks = static_cast<uint32_t>(
+            std::strtod(value, nullptr) / config.arena.tick_seconds);
+      } else {
+        std::cerr << "Unknown argument: " << arg << "\n";
+        return 1;
+      }
+    } else if (policy_path.empty()) {
+      policy_path = arg;
+    } else {
+      std::cerr << "Unexpected argument: " << arg << "\n";
+      return 1;
+    }
+  }
+  if (policy_path.empty()) {
+    std::cerr << "usage: " << argv[0]
+              << " <qtable> [--opponent scripted|<qtable>]... [--matches n]"
+                 " [--threads n] [--seed n] [--seconds n]\n";
+    return 1;
+  }
+  if (opponents.empty()) {
+    opponents.push_back("scripted");
+  }
+
+  try {
+    wbz::ai::QLearningAgent policy;
+    policy.load_table(policy_path);
+    wbz::env::Evaluator evaluator(policy, config);
+
+    for (const std::string &name : opponents) {
+      wbz::env::EvaluationReport report;
+      if (name == "scripted") {
+        report = evaluator.against_scripted();
+      } else {
+        wbz::ai::QLearningAgent opponent;
+        opponent.load_table(name);
+        report = evaluator.against(opponent);
+      }
+
+      std::cout << std::fixed << std::setprecision(3) << "vs " << name
+                << ": " << report.matches << " matches, " << report.wins
+                << "-" << report.draws << "-" << report.losses
+                << " (W-D-L), intervals at z = " << config.z << "\n";
+      print_estimate("win rate", report.win_rate, "");
+      std::cout << std::setprecision(1);
+      print_estimate("damage dealt", report.damage_dealt, " hp");
+      print_estimate("damage taken", report.damage_taken, " hp");
+      std::cout << std::setprecision(2);
+      print_estimate("round length", report.round_seconds, " s");
+      std::cout << "  " << report.seconds << " s on " << report.threads
+                << " threads: " << std::setprecision(0)
+                << report.matches_per_core_second() << " matches/s/core\n";
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Evaluation failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
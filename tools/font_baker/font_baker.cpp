@@ -0,0 +1,127 @@
+// Bakes a TrueType font into a glyph atlas plus a metrics table readable by
+// wbz::BitmapFont, so the runtime can draw text without SDL_ttf.
+//
+// usage: font_baker <font.ttf> <output dir> <name> <size>...
+
+#include <SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int FIRST_GLYPH = 32;
+constexpr int LAST_GLYPH = 126;
+constexpr int ATLAS_WIDTH = 512;
+constexpr int PADDING = 1;
+
+struct BakedGlyph {
+  int codepoint;
+  SDL_Surface *surface;
+  int advance;
+  SDL_Rect rect;
+};
+
+struct BakedFace {
+  int size;
+  int line_height;
+  std::vector<BakedGlyph> glyphs;
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 5) {
+    std::cerr << "usage: " << argv[0]
+              << " <font.ttf> <output dir> <name> <size>...\n";
+    return 1;
+  }
+
+  const std::string font_path = argv[1];
+  const std::string output_dir = argv[2];
+  const std::string name = argv[3];
+
+  if (TTF_Init() == -1) {
+    std::cerr << "Failed to initialize SDL_ttf\n";
+    return 1;
+  }
+
+  std::vector<BakedFace> faces;
+  int cursor_x = 0, cursor_y = 0, row_height = 0;
+
+  for (int i = 4; i < argc; ++i) {
+    int size = std::stoi(argv[i]);
+    TTF_Font *font = TTF_OpenFont(font_path.c_str(), size);
+    if (!font) {
+      std::cerr << "Failed to open " << font_path << " at size " << size
+                << "\n";
+      return 1;
+    }
+
+    BakedFace face{size, TTF_FontLineSkip(font), {}};
+    for (int codepoint = FIRST_GLYPH; codepoint <= LAST_GLYPH; ++codepoint) {
+      int advance = 0;
+      TTF_GlyphMetrics(font, static_cast<Uint16>(codepoint), nullptr, nullptr,
+                       nullptr, nullptr, &advance);
+
+      SDL_Surface *surface = TTF_RenderGlyph_Blended(
+          font, static_cast<Uint16>(codepoint), {255, 255, 255, 255});
+      int w = surface ? surface->w : 0;
+      int h = surface ? surface->h : 0;
+
+      if (cursor_x + w > ATLAS_WIDTH) {
+        cursor_x = 0;
+        cursor_y += row_height + PADDING;
+        row_height = 0;
+      }
+
+      face.glyphs.push_back({codepoint, surface, advance,
+                             SDL_Rect{cursor_x, cursor_y, w, h}});
+      cursor_x += w + PADDING;
+      row_height = std::max(row_height, h);
+    }
+
+    faces.push_back(std::move(face));
+    TTF_CloseFont(font);
+  }
+
+  int atlas_height = cursor_y + row_height;
+  SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(
+      0, ATLAS_WIDTH, atlas_height, 32, SDL_PIXELFORMAT_RGBA32);
+  SDL_FillRect(atlas, nullptr, 0);
+
+  const std::string atlas_file = name + ".png";
+  std::ofstream metrics(output_dir + "/" + name + ".fnt");
+  metrics << "# baked from " << font_path << "\n";
+  metrics << "atlas " << atlas_file << "\n";
+
+  for (auto &face : faces) {
+    metrics << "face " << face.size << " " << face.line_height << "\n";
+    for (auto &glyph : face.glyphs) {
+      if (glyph.surface) {
+        SDL_SetSurfaceBlendMode(glyph.surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(glyph.surface, nullptr, atlas, &glyph.rect);
+        SDL_FreeSurface(glyph.surface);
+      }
+      metrics << "glyph " << glyph.codepoint << " " << glyph.rect.x << " "
+              << glyph.rect.y << " " << glyph.rect.w << " " << glyph.rect.h
+              << " " << glyph.advance << "\n";
+    }
+  }
+
+  if (IMG_SavePNG(atlas, (output_dir + "/" + atlas_file).c_str()) != 0) {
+    std::cerr << "Failed to write atlas: " << IMG_GetError() << "\n";
+    return 1;
+  }
+
+  std::cout << "Baked " << faces.size() << " sizes of " << font_path
+            << " into " << ATLAS_WIDTH << "x" << atlas_height << " atlas\n";
+
+  SDL_FreeSurface(atlas);
+  TTF_Quit();
+  return 0;
+}
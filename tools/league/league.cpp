@@ -0,0 +1,66 @@
+// Runs a self-play league and reports match throughput and the final
+// ratings.
+//
+// usage: league [agents] [rounds] [threads] [match seconds] [snapshot dir]
+
+#include "env/league.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+  auto arg = [&](int index, unsigned long fallback) {
+    return argc > index ? std::strtoul(argv[index], nullptr, 10) : fallback;
+  };
+
+  wbz::env::LeagueConfig config;
+  config.agents = arg(1, 16);
+  const unsigned long rounds = arg(2, 50);
+  config.threads = arg(3, 0);
+  config.match_ticks =
+      static_cast<uint32_t>(arg(4, 30) / config.tick_seconds);
+  if (argc > 5) {
+    config.snapshot_dir = argv[5];
+  }
+
+  try {
+    wbz::env::League league(config, 1);
+
+    double seconds = 0.0;
+    uint64_t ticks = 0;
+    for (unsigned long round = 1; round <= rounds; ++round) {
+      const auto result = league.play_round();
+      seconds += result.seconds;
+      ticks += result.ticks;
+      if (round % 10 == 0 || round == rounds) {
+        std::cout << "Round " << round << ": " << result.matches
+                  << " matches in " << result.seconds * 1e3 << " ms\n";
+      }
+    }
+
+    std::cout << league.matches() << " matches in " << seconds << " s: "
+              << league.matches() / seconds << " matches/s, "
+              << ticks / seconds << " match ticks/s\n";
+
+    std::vector<const wbz::env::LeagueMember *> standings;
+    for (const auto &member : league.members()) {
+      standings.push_back(&member);
+    }
+    std::sort(standings.begin(), standings.end(),
+              [](const auto *a, const auto *b) {
+                return a->rating > b->rating;
+              });
+    for (const auto *member : standings) {
+      std::cout << std::setw(14) << member->name << std::setw(8)
+                << std::fixed << std::setprecision(0) << member->rating
+                << "  " << member->wins << "-" << member->losses << "-"
+                << member->draws << (member->frozen ? "  frozen" : "")
+                << "\n";
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "League failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
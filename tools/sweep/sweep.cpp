@@ -0,0 +1,102 @@
+// Runs a hyperparameter sweep of the Q-learning agent: every configuration
+// of a spec file trained in its own headless arena, once per seed, across
+// all cores. Prints a table of configurations ranked by final win rate and
+// optionally writes every run to a CSV file.
+//
+// usage: sweep <spec> [results.csv] [threads]
+
+#include "env/sweep.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+struct ConfigurationSummary {
+  size_t configuration = 0;
+  size_t runs = 0;
+  float final_win_rate = 0.0f;
+  float final_reward = 0.0f;
+  double seconds = 0.0;
+};
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <spec> [results.csv] [threads]\n";
+    return 1;
+  }
+  const size_t threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+
+  try {
+    const wbz::env::Sweep sweep(wbz::env::SweepSpec::load(argv[1]));
+    const auto &jobs = sweep.jobs();
+    std::cout << "Sweeping " << jobs.size() << " runs of "
+              << sweep.spec().ticks << " ticks\n";
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = sweep.run(threads);
+    const double wall = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+    if (argc > 2) {
+      sweep.write_csv(argv[2], results);
+    }
+
+    std::vector<ConfigurationSummary> summaries;
+    double cpu = 0.0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      if (summaries.empty() ||
+          summaries.back().configuration != jobs[i].configuration) {
+        summaries.push_back({jobs[i].configuration});
+      }
+      auto &summary = summaries.back();
+      ++summary.runs;
+      summary.final_win_rate += results[i].final_win_rate;
+      summary.final_reward += results[i].reward_curve.back();
+      summary.seconds += results[i].seconds;
+      cpu += results[i].seconds;
+    }
+    for (auto &summary : summaries) {
+      summary.final_win_rate /= summary.runs;
+      summary.final_reward /= summary.runs;
+    }
+    std::stable_sort(summaries.begin(), summaries.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.final_win_rate > b.final_win_rate;
+                     });
+
+    std::cout << std::setw(6) << "config";
+    for (const auto &param : sweep.spec().parameters) {
+      std::cout << std::setw(22) << param.name;
+    }
+    std::cout << std::setw(10) << "win rate" << std::setw(12) << "reward"
+              << std::setw(10) << "seconds\n";
+    for (const auto &summary : summaries) {
+      const auto &params =
+          std::find_if(jobs.begin(), jobs.end(), [&](const auto &job) {
+            return job.configuration == summary.configuration;
+          })->params;
+      std::cout << std::setw(6) << summary.configuration << std::fixed;
+      for (const auto &param : sweep.spec().parameters) {
+        std::cout << std::setw(22) << std::setprecision(4)
+                  << wbz::env::SweepSpec::value(params, param.name);
+      }
+      std::cout << std::setw(10) << std::setprecision(3)
+                << summary.final_win_rate << std::setw(12)
+                << std::setprecision(1) << summary.final_reward
+                << std::setw(9) << std::setprecision(2) << summary.seconds
+                << "\n";
+    }
+
+    std::cout << jobs.size() << " runs in " << std::setprecision(2) << wall
+              << " s wall, " << cpu << " s of runs ("
+              << cpu / wall << "x parallel)\n";
+  } catch (const std::exception &e) {
+    std::cerr << "Sweep failed: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
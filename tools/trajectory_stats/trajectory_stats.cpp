@@ -0,0 +1,99 @@
+// Summarizes a trajectory log written with --trajectory, timing a raw pass
+// over its records and, optionally, passes of offline Q-learning over them.
+//
+// usage: trajectory_stats <file> [training passes]
+
+#include "entities/agent/trajectory_log.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <file> [training passes]\n";
+    return 1;
+  }
+  const unsigned long passes =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+
+  wbz::ai::TrajectoryReader reader;
+  try {
+    reader.open(argv[1]);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  const auto &header = reader.header();
+  const auto episodes = reader.episodes();
+  uint64_t terminal = 0;
+  double total_return = 0.0;
+  for (const auto &episode : episodes) {
+    terminal += episode.terminal;
+    total_return += episode.total_reward;
+  }
+  std::cout << header.transition_count << " transitions in "
+            << header.episode_count << " episodes (" << terminal
+            << " ended in a defeat), seed " << header.seed << "\n";
+  if (!episodes.empty()) {
+    std::cout << "Mean episode return " << total_return / episodes.size()
+              << ", mean length "
+              << static_cast<double>(header.transition_count) /
+                     episodes.size()
+              << "\n";
+  }
+
+  // One sequential pass over every record.
+  auto start = std::chrono::steady_clock::now();
+  const auto *records = reader.records();
+  double reward = 0.0;
+  constexpr int ACTIONS = static_cast<int>(wbz::ai::Action::ACTION_COUNT);
+  uint64_t actions[ACTIONS] = {};
+  for (uint64_t i = 0; i < header.record_count; ++i) {
+    if (records[i].kind == wbz::ai::TrajectoryRecord::TRANSITION) {
+      reward += records[i].reward;
+      ++actions[records[i].action % ACTIONS];
+    }
+  }
+  double seconds = seconds_since(start);
+  std::cout << "Scanned " << header.record_count << " records in "
+            << seconds * 1e3 << " ms ("
+            << header.record_count * sizeof(wbz::ai::TrajectoryRecord) /
+                   (seconds * 1e9)
+            << " GB/s), total reward " << reward << "\nActions:";
+  for (int action = 0; action < ACTIONS; ++action) {
+    std::cout << " " << actions[action];
+  }
+  std::cout << "\n";
+
+  if (passes == 0) {
+    return 0;
+  }
+
+  wbz::ai::QLearningAgent agent;
+  start = std::chrono::steady_clock::now();
+  for (unsigned long pass = 0; pass < passes; ++pass) {
+    for (const auto &episode : episodes) {
+      for (uint64_t i = episode.first_record;
+           i < episode.first_record + episode.length; ++i) {
+        const auto &record = records[i];
+        agent.update(record.state.unpack(),
+                     static_cast<wbz::ai::Action>(record.action),
+                     record.reward, record.next_state.unpack());
+      }
+    }
+  }
+  seconds = seconds_since(start);
+  std::cout << "Trained " << passes << " passes, "
+            << passes * header.transition_count / seconds
+            << " transitions/s\n";
+  return 0;
+}